@@ -31,7 +31,7 @@ bool handle_exception()
 		const char *serror[] = {
 			"ExpectFunction", "BadFunctionCallArgs", "BadFunctionCallArgc", "BadFunctionCallArgType",
 			"ExpandEmptyArray", "AssignLeftValue", "MathOperationWithNaNOrInf", "IntDivOrModByZero",
-			"NoAvailableID", "BadAlloc", "BadSymbolInsertion" };
+			"NoAvailableID", "BadAlloc", "BadSymbolInsertion", "NonBatchableUnit" };
 		std::cout << "RuntimeError: " << serror[e.error - 1] << std::endl;
 	} else if (se_catch_any(&e))
 	{
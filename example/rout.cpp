@@ -30,10 +30,13 @@ int rout(se_context_t *ctx, const std::string &s)
 		{
 			printf(
 			"instruction:\n"
-			"    :help    - print this page\n"
-			"    :version - print version\n"
-			"    :clear   - clear the screen\n"
-			"    :quit    - quit REPL\n"
+			"    :help     - print this page\n"
+			"    :version  - print version\n"
+			"    :clear    - clear the screen\n"
+			"    :stack    - execute with the element frame stack (default)\n"
+			"    :register - execute with the register VM\n"
+			"    :jit      - register VM with native code for hot numeric statements\n"
+			"    :quit     - quit REPL\n"
 			"built-in function:\n"
 			"    id(x) sin(x) cos(x) tan(x) asin(x) acos(x) atan(x)\n"
 			"    exp(x) factorial(x) int(x) random() sum(...) mul(...)\n"
@@ -70,6 +73,24 @@ int rout(se_context_t *ctx, const std::string &s)
 			"assign operator: = += -= *= /= %%= |= &= ^= >>= <<=\n");
 			break;
 		}
+		case 'r': // register
+		{
+			se_ctx_set_executor(ctx, SE_EXEC_REGISTER);
+			printf("executor: register\n");
+			break;
+		}
+		case 's': // stack
+		{
+			se_ctx_set_executor(ctx, SE_EXEC_STACK);
+			printf("executor: stack\n");
+			break;
+		}
+		case 'j': // jit
+		{
+			se_ctx_set_executor(ctx, SE_EXEC_JIT);
+			printf("executor: jit\n");
+			break;
+		}
 		case 'c': // clear
 		{
 			int retcode = system(
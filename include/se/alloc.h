@@ -2,7 +2,8 @@
 #include <stdint.h>
 
 // 1. 下列内存管理函数是针对se特化的内存池版本
-// 2. 以下函数是线程不安全的
+// 2. 当前内存分配器是线程局部的，各线程可同时使用不同的内存分配器
+//    同一内存分配器在同一时刻只能由一个线程使用
 // 3. 推荐将se_alloc_cleanup注册给atexit
 // 4. 以下函数是内存不安全的，错误的函数使用方法将导致无法预料的错误
 
@@ -25,6 +26,7 @@ void* se_alloc(size_t size); // 申请内存
 void* se_realloc(void *pb, size_t size); // 调整内存大小
 void  se_free(void *pb); // 释放内存
 size_t se_msize(void *pb); // 获取内存大小
+void  se_alloc_trim(); // 归还空闲的内存块
 
 #ifdef __cplusplus
 }
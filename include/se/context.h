@@ -12,6 +12,14 @@
 #define ECTX_ERROR   3 // seus语句错误
 #define ECTX_WAIT    4 // seus待执行
 
+#define SE_EXEC_STACK    0 // 以元素帧栈逐单元执行（默认）
+#define SE_EXEC_REGISTER 1 // 编译为寄存器指令后执行，无法编译的语句仍以元素帧栈执行
+#define SE_EXEC_JIT      2 // 同SE_EXEC_REGISTER，反复执行的纯数值语句编译为本机代码（仅x86-64，其余平台同SE_EXEC_REGISTER）
+
+#define SE_FUSE_NONE    0 // 逐单元执行
+#define SE_FUSE_ALL     1 // 常见的单元序列融合为超级指令执行（默认）
+#define SE_FUSE_PROFILE 2 // 先逐单元执行并统计相邻单元的动作对，按出现频率选取融合的超级指令
+
 typedef struct se_context_s
 {
 	seus_t seus; // current se unit stream
@@ -26,6 +34,29 @@ typedef struct se_context_s
 	const char *next_statement;
 } se_context_t;
 
+typedef struct se_program_s
+{	// 预编译的语句，可在环境中重复执行
+	seus_t seus;  // 程序持有的SEUS
+	char *source; // 语句源码副本（seus的单元指向此处）
+} se_program_t;
+
+typedef struct se_script_s
+{	// 预编译的多语句脚本，progs按语句顺序排列，依次由se_ctx_run执行
+	se_program_t *progs; // 各语句的程序（空语句不计入，progs[i].source为0L）
+	int nprogs;          // 程序数
+	char *text;          // 脚本源码副本（各程序的单元指向此处）
+} se_script_t;
+
+// 读取回调：向buffer写入至多size字节的SE代码，返回写入的字节数，返回0表示代码已读完
+typedef size_t (*se_reader_t)(void *data, char *buffer, size_t size);
+
+typedef struct se_column_s
+{	// 批量执行的输入列
+	const char *symbol; // 绑定的符号
+	int type;           // EN_DEC: int32_t数组，EN_FLT: double数组
+	const void *data;   // 列数据（至少nrows个元素）
+} se_column_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,16 +65,33 @@ extern "C" {
 int se_ctx_create  (se_context_t *ctx); // 创建环境
 int se_ctx_destroy (se_context_t *ctx); // 销毁环境
 int se_ctx_load    (se_context_t *ctx, const char *script); // 载入SE代码（若代码已经存在，则向后连接）
+// 以读取回调流式载入SE代码，已载入的代码执行完毕后按需读取，执行过的代码随即释放
+// 回调读完之前载入的其他代码排在回调的代码之后执行
+int se_ctx_load_reader(se_context_t *ctx, se_reader_t reader, void *data);
+// 以只读映射载入SE代码文件，语句直接在映射中解析，执行完毕后解除映射
+int se_ctx_load_file(se_context_t *ctx, const char *path);
 int se_ctx_complete(se_context_t *ctx); // 判断代码是否全部执行完毕
 int se_ctx_forward (se_context_t *ctx); // 读取下一个语句
 int se_ctx_parse   (se_context_t *ctx); // 解析当前语句并构建SEUS
-int se_ctx_compile (se_context_t *ctx); // 编译全部代码（未实现）
+int se_ctx_compile (se_context_t *ctx, const char *script, se_program_t *prog); // 将首个语句编译为程序
 int se_ctx_onestep (se_context_t *ctx, unit_t *unit); // 单步执行
 int se_ctx_execute (se_context_t *ctx); // 执行SEUS
+int se_ctx_run     (se_context_t *ctx, se_program_t *prog); // 执行程序，结果由se_ctx_get_last_ret获取
+int se_ctx_discard (se_context_t *ctx, se_program_t *prog); // 释放程序
+int se_ctx_set_executor(se_context_t *ctx, int executor); // 选择执行器（SE_EXEC_*），对之后执行的语句生效
+int se_ctx_set_fusion  (se_context_t *ctx, int mode); // 选择栈动作执行时单元序列的融合方式（SE_FUSE_*）
+// 按';'拆分脚本，以nthreads个线程并行编译全部语句（nthreads<=0时取处理器数）
+// 任一语句编译失败时抛出首个出错语句的异常并返回非零值
+int se_ctx_compile_script(se_context_t *ctx, const char *script, int nthreads, se_script_t *out);
+int se_ctx_discard_script(se_context_t *ctx, se_script_t *script); // 释放脚本
+// 按列批量执行纯数值表达式，第i行的结果写入out[i]；未绑定列的符号取环境中的当前值
+// 任一行出错时抛出与逐行执行相同的异常并返回非零值，此时out的内容不可靠
+int se_ctx_batch   (se_context_t *ctx, se_program_t *prog,
+	const se_column_t *columns, int ncolumns, size_t nrows, se_number_t *out);
 int se_ctx_savetmp (se_context_t *ctx, void *data, int type, void **pp); // 保存临时值
 int se_ctx_bind    (se_context_t *ctx, void *data, int type, const char *symbol); // 将数据绑定到对象
 int se_ctx_unbind  (se_context_t *ctx, const char *symbol); // 对象解绑定
-int se_ctx_sweep   (se_context_t *ctx); // 清理内存（未实现）
+int se_ctx_sweep   (se_context_t *ctx); // 回收不可达的临时值并归还空闲内存
 
 void* se_ctx_request(se_context_t *ctx, size_t size); // 请求一块内存
 void  se_ctx_release(se_context_t *ctx, void *ptr);   // 释放从se_ctx_request请求的内存
@@ -2,6 +2,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <se/thread.h>
 
 typedef struct se_exception_s
 {
@@ -15,8 +16,17 @@ typedef struct se_exception_s
 extern "C" {
 #endif
 
+// 异常状态为线程局部，各线程独立抛出与捕获
+extern SE_THREAD_LOCAL se_exception_t g_se_exception;
+
 void se_throw(uint32_t etype, uint32_t error, uint64_t extra, uint64_t reserved);
-int se_caught();
+
+// 无异常时返回1；内联以便热循环直接分支
+static inline int se_caught()
+{
+	return g_se_exception.etype == 0;
+}
+
 int se_catch(se_exception_t *e, uint32_t type);
 int se_catch_err(se_exception_t *e, uint32_t type, uint32_t error);
 int se_catch_any(se_exception_t *e);
@@ -76,4 +86,5 @@ int se_catch_any(se_exception_t *e);
 #define IntDivOrModByZero      0x08 // 整数除法、求模以零为右操作数
 #define NoAvailableID          0x09 // 运行时ID分配失败
 #define BadAlloc               0x0a // 内存分配失败
-#define BadSymbolInsertion     0x0b // 添加符号失败
\ No newline at end of file
+#define BadSymbolInsertion     0x0b // 添加符号失败
+#define NonBatchableUnit       0x0c // 语句包含无法批量执行的单元
\ No newline at end of file
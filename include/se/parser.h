@@ -32,6 +32,9 @@ typedef struct unit_s
 {	// { extra: 4, major_type: 4, sub_type: 8 }
 	uint16_t type;
 	uint16_t len;
+	uint16_t act; // action id linked by context, 0 if unlinked
+	uint16_t idx; // constant pool index for numbers, interned symbol id for symbols (0 if unresolved),
+	              // units to skip for short-circuit jumps
 	const char *tok;
 } unit_t;
 
@@ -47,8 +50,13 @@ typedef struct seus_s
 	uint16_t     nvf;
 	uint16_t     nss;
 	uint16_t     nus;
+	uint16_t     ncs;
 	scopestate_t *ss;
 	unit_t       *us;
+	se_number_t  *cs; // constant pool, literals decoded once at link time
+	uint32_t     symgen; // symbol table generation the interned symbol ids belong to
+	void         *rvm;   // register code, compiled by the context on first register run
+	uint32_t     fusegen; // superinstruction set generation the unit actions were fused for (0 if unfused)
 } seus_t;
 
 #define SE_UNIT_TYPE(e) ((e).type >> 8 & 0xf)
@@ -95,6 +103,10 @@ unit_t* toks2rpn(token_t *tokens, int ntok, int *psize);
 
 // step 2 compile, convert Reverse Polish notion to Simple Eval Unit Stream
 seus_t rpn2seus(unit_t *units, int n);
+
+// single pass compile, convert tokens to Simple Eval Unit Stream directly
+// buffers already held by seus are reused, returns 0 on success
+int toks2seus(const token_t *tokens, int ntok, seus_t *seus);
 void free_seus(seus_t *seus);
 
 #ifdef __cplusplus
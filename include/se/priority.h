@@ -102,6 +102,8 @@
 #define OP_XOR_ASS 0x25 // assign after xor
 #define OP_OR_ASS  0x26 // assign after or
 #define OP_CME     0x27 // comma expression
+#define OP_LAND_JMP 0x28 // short-circuit jump of logical and, inserted by the parser
+#define OP_LOR_JMP  0x29 // short-circuit jump of logical or, inserted by the parser
 
 #define OP_RANGE_MIN OP_BRE
 #define OP_RANGE_MAX OP_CME
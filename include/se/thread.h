@@ -0,0 +1,58 @@
+#pragma once
+
+// 线程局部存储与自旋锁的编译器适配
+// 自旋锁仅用于保护低频的全局结构（如内存池链表），不应出现在求值路径上
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	define SE_THREAD_LOCAL __declspec(thread)
+#else
+#	define SE_THREAD_LOCAL __thread
+#endif
+
+typedef volatile long se_atomic_t;
+typedef se_atomic_t   se_spinlock_t;
+
+#define SE_SPINLOCK_INIT 0
+
+static inline long se_atomic_load(se_atomic_t *p)
+{
+#if defined(_MSC_VER)
+	return _InterlockedOr(p, 0);
+#else
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline long se_atomic_inc(se_atomic_t *p)
+{
+#if defined(_MSC_VER)
+	return _InterlockedIncrement(p);
+#else
+	return __atomic_add_fetch(p, 1, __ATOMIC_ACQ_REL);
+#endif
+}
+
+static inline void se_spin_lock(se_spinlock_t *lock)
+{
+#if defined(_MSC_VER)
+	while (_InterlockedExchange(lock, 1) != 0)
+	{
+		while (*lock != 0) _mm_pause();
+	}
+#else
+	while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0)
+	{
+		while (__atomic_load_n(lock, __ATOMIC_RELAXED) != 0);
+	}
+#endif
+}
+
+static inline void se_spin_unlock(se_spinlock_t *lock)
+{
+#if defined(_MSC_VER)
+	_InterlockedExchange(lock, 0);
+#else
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+#endif
+}
@@ -4,6 +4,244 @@
 
 #include <math.h>
 
+///-------- number semantics --------
+// 以下数值运算与对象栈无关，逐单元执行与批量执行（batch.c）共用同一语义
+
+// 检查参与运算的数值
+static inline int se_number_check(const se_number_t *num)
+{
+	if (num->nan || num->inf)
+	{
+		se_throw(RuntimeError, MathOperationWithNaNOrInf, num->nan, num->inf);
+		return 1;
+	}
+	return 0;
+}
+
+static inline void se_number_sign(int op, const se_number_t *x, se_number_t *r)
+{
+	*r = *x;
+	if (op == OP_NL)
+	{
+		if (r->type == EN_FLT)
+		{
+			r->f = -r->f;
+		} else
+		{
+			r->inf = r->i < 0 && -r->i < 0;
+			r->i = -r->i;
+		}
+	}
+}
+
+static inline int se_number_basecalc(int op, const se_number_t *x, const se_number_t *y, se_number_t *r)
+{
+	int useflt = x->type == EN_FLT || y->type == EN_FLT;
+
+	if (useflt && op == OP_MOD)
+	{
+		se_throw(TypeError, ModuloWithFloat, 0, 0);
+		return 1;
+	}
+
+	int32_t ix = x->i;
+	int32_t iy = y->i;
+	double  fx = x->type == EN_FLT ? x->f : ix * 1.0;
+	double  fy = y->type == EN_FLT ? y->f : iy * 1.0;
+
+	int32_t ri;
+	double  rf;
+
+	int inf = 0;
+
+	switch (op)
+	{
+		case OP_ADD:
+		{
+			if (useflt)
+			{
+				rf = fx + fy;
+			} else
+			{
+				ri = ix + iy;
+				inf = (ix & iy & ~ri) >> 31;
+			}
+		}
+		break;
+		case OP_SUB:
+		{
+			if (useflt)
+			{
+				rf = fx - fy;
+			} else
+			{
+				ri = ix - iy;
+				inf = (ix & ~iy & ~ri) >> 31;
+			}
+		}
+		break;
+		case OP_MOD:
+		{
+			if (iy == 0)
+			{
+				se_throw(RuntimeError, IntDivOrModByZero, 0, 0);
+				return 1;
+			}
+			ri = ix % iy;
+		}
+		break;
+		case OP_MUL:
+		{
+			if (useflt)
+			{
+				rf = fx * fy;
+			} else
+			{
+				ri = ix * iy;
+				if (iy != 0)
+				{
+					inf = ri / iy != ix;
+				}
+			}
+		}
+		break;
+		case OP_DIV:
+		{
+			if (!useflt && iy == 0)
+			{
+				se_throw(RuntimeError, IntDivOrModByZero, 0, 0);
+				return 1;
+			}
+			if (useflt)
+			{
+				rf = fx / fy;
+			} else
+			{
+				ri = ix / iy;
+			}
+		}
+		break;
+	}
+
+	if (useflt)
+	{
+		r->f = rf;
+		r->type = EN_FLT;
+		r->inf = isinf(rf);
+		r->nan = isnan(rf);
+	} else
+	{
+		r->i = ri;
+		r->type = EN_DEC;
+		r->inf = inf;
+		r->nan = 0;
+	}
+
+	return 0;
+}
+
+static inline void se_number_compare(int op, const se_number_t *x, const se_number_t *y, se_number_t *r)
+{
+	r->type = EN_DEC;
+	r->inf  = 0;
+	r->nan  = 0;
+
+	switch (op)
+	{
+#define CMP(L, OP, R) \
+(	((L)->type == EN_FLT ? (L)->f : (L)->i) OP  \
+	((R)->type == EN_FLT ? (R)->f : (R)->i)	)
+		case OP_GTR:  r->i = CMP(x,  >, y); break;
+		case OP_GEQ:  r->i = CMP(x, >=, y); break;
+		case OP_LSS:  r->i = CMP(x,  <, y); break;
+		case OP_LEQ:  r->i = CMP(x, <=, y); break;
+		case OP_EQU:  r->i = CMP(x, ==, y); break;
+		case OP_NEQ:  r->i = CMP(x, !=, y); break;
+		case OP_LAND: r->i = CMP(x, &&, y); break;
+		case OP_LOR:  r->i = CMP(x, ||, y); break;
+#undef CMP
+	}
+}
+
+// 逻辑与、逻辑或的短路（op为OP_LAND或OP_LOR），左操作数已决定结果时写入r并返回1
+// nan与inf不作判断，由运算符本身报告异常
+static inline int se_number_decide(int op, const se_number_t *x, se_number_t *r)
+{
+	if (x->nan || x->inf)
+	{
+		return 0;
+	}
+
+	const int truth = x->type == EN_FLT ? x->f != 0 : x->i != 0;
+	if (truth != (op == OP_LOR))
+	{
+		return 0;
+	}
+
+	r->i    = truth;
+	r->type = EN_DEC;
+	r->inf  = 0;
+	r->nan  = 0;
+
+	return 1;
+}
+
+static inline void se_number_lnot(const se_number_t *x, se_number_t *r)
+{
+	r->i    = x->type == EN_FLT ? !x->f : !x->i;
+	r->type = EN_DEC;
+	r->inf  = 0;
+	r->nan  = 0;
+}
+
+static inline int se_number_not(const se_number_t *x, se_number_t *r)
+{
+	if (x->type == EN_FLT)
+	{
+		se_throw(TypeError, BitwiseOpWithFloat, 0, 0);
+		return 1;
+	}
+
+	r->i    = ~x->i;
+	r->type = x->type;
+	r->inf  = 0;
+	r->nan  = 0;
+
+	return 0;
+}
+
+static inline int se_number_bitop(int op, const se_number_t *x, const se_number_t *y, se_number_t *r)
+{
+	if (x->type == EN_FLT)
+	{
+		se_throw(TypeError, BitwiseOpWithFloat, 0, 0);
+		return 1;
+	}
+
+	if (y->type == EN_FLT)
+	{
+		se_throw(TypeError, BitwiseOpWithFloat, 0, 0);
+		return 1;
+	}
+
+	int32_t t;
+	switch (op)
+	{
+		case OP_LSH: t = x->i << y->i; break;
+		case OP_RSH: t = x->i >> y->i; break;
+		case OP_AND: t = x->i  & y->i; break;
+		case OP_XOR: t = x->i  ^ y->i; break;
+		case OP_OR:  t = x->i  | y->i; break;
+	}
+
+	r->i    = t;
+	r->type = x->type;
+	r->inf  = 0;
+	r->nan  = 0;
+
+	return 0;
+}
+
 // 检查是否为合法数字类型
 static int se_ctx_check_number(se_object_t *obj, se_object_t *placer)
 {
@@ -18,14 +256,12 @@ static int se_ctx_check_number(se_object_t *obj, se_object_t *placer)
 		obj = (se_object_t*)obj->data;
 	}
 
-	se_number_t *num = (se_number_t*)obj->data;
 	if (obj->type != EO_NUM)
 	{
 		se_throw(TypeError, MathOperationAmongNonNumbers, obj->type, 0);
 		return 1;
-	} else if (num->nan || num->inf)
+	} else if (se_number_check((se_number_t*)obj->data) != 0)
 	{
-		se_throw(RuntimeError, MathOperationWithNaNOrInf, num->nan, num->inf);
 		return 1;
 	}
 
@@ -36,30 +272,99 @@ static int se_ctx_check_number(se_object_t *obj, se_object_t *placer)
 	return 0;
 }
 
-static int se_ctx_action_assign_symbol(se_context_t *ctx, unit_t *unit)
-{	// 符号分配
-	assert(ctx != 0L);
-
+// 将数值存入语句内存区，随语句结束整体释放
+// 内存区空间不足时（如直接单步执行）退回为se_ctx_savetmp
+static int se_ctx_savenum(se_context_t *ctx, const se_number_t *num, se_number_t **pp)
+{
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
-	assert(ctxmem != 0L);
 
-	assert(unit != 0L);
-	assert(SE_UNIT_TYPE(*unit) == T_SYMBOL);
+	se_number_t *p = (se_number_t*)se_ctx_arena_alloc(ctxmem, sizeof(se_number_t));
+	if (p != 0L)
+	{
+		*p  = *num;
+		*pp = p;
+		return 0;
+	}
+
+	return se_ctx_savetmp(ctx, (void*)num, EO_NUM, (void**)pp);
+}
+
+// 值将脱离当前语句时，把位于语句内存区中的数值转存至内存池
+static int se_ctx_promote(se_context_t *ctx, se_object_t *obj)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 
-	char *symbol = (char*)se_ctx_request(ctx, unit->len + 1);
-	if (symbol == 0L)
+	if (obj->type != EO_NUM || !se_ctx_in_arena(ctxmem, obj->data))
 	{
-		se_throw(RuntimeError, BadAlloc, unit->len + 1, 0);
-		return 1;
+		return 0;
 	}
 
-	memcpy(symbol, unit->tok, unit->len);
-	symbol[unit->len] = '\0';
+	return se_ctx_savetmp(ctx, obj->data, EO_NUM, &obj->data);
+}
 
-	s2inode_t *pair = hashmap_find_by_key(&ctxmem->symmap, symbol);
+// unit_t.act 动作编号
+#define SE_ACT_NOP        0
+#define SE_ACT_SYMBOL     1
+#define SE_ACT_NUMBER     2
+#define SE_ACT_SCOPE      3
+#define SE_ACT_BRACKET    4
+#define SE_ACT_FNCALL     5
+#define SE_ACT_INDEX      6
+#define SE_ACT_MAKEARRAY  7
+#define SE_ACT_ASSIGN     8
+#define SE_ACT_COMMA     9
+#define SE_ACT_EXPARRAY  10
+#define SE_ACT_SIGN      11
+#define SE_ACT_BASECALC  12
+#define SE_ACT_COMPARE   13
+#define SE_ACT_LNOT      14
+#define SE_ACT_NOT       15
+#define SE_ACT_BITOP     16
+#define SE_ACT_CALC_ASS  17
+#define SE_ACT_JUMP      18
+// 超级指令：融合后的单元序列由首单元的动作一并执行，其余单元原样保留（见fuse.c）
+#define SE_ACT_LOAD_OP   19 // 操作数、二元运算（左操作数位于栈顶）
+#define SE_ACT_LOAD2_OP  20 // 操作数、操作数、二元运算
+#define SE_ACT_SCOPED    21 // 括号域起始、操作数、括号域结束（单值括号、单参数函数调用或索引）
+#define SE_ACT_COUNT     22
+
+#define SE_ACT_FUSED     SE_ACT_LOAD_OP // 首个超级指令的编号
+
+// 动作的返回值：0为成功，1为出错，不小于SE_ACT_SKIPPED时跳过其后的（返回值-SE_ACT_SKIPPED）个单元
+#define SE_ACT_SKIPPED    2
+#define SE_ACT_SKIP(n)   (SE_ACT_SKIPPED + (n))
+
+///-------- object semantics --------
+// 以下运算以对象为操作数，元素帧栈的动作与寄存器虚拟机（regvm.c）共用同一语义
+
+// 取符号对应的持续对象，新符号在此时加入符号表
+static int se_ctx_load_symbol(se_context_t *ctx, unit_t *unit, se_object_t *out)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 
-	if (pair == 0L)
+	// 已查找过的符号直接以id访问持续空间
+	seus_t *seus = ctxmem->seus;
+	const int owned = seus != 0L && unit >= seus->us && unit < seus->us + seus->nus
+		&& seus->symgen == ctxmem->symgen;
+	if (owned && unit->idx != 0)
 	{
+		*out = ctxmem->idstorage[unit->idx - 1];
+		return 0;
+	}
+
+	s2inode_t *pair = hashmap_find_by_span(&ctxmem->symmap, unit->tok, unit->len);
+
+	if (pair == 0L)
+	{	// 新符号的键转存至内存池
+		char *symbol = (char*)se_ctx_request(ctx, unit->len + 1);
+		if (symbol == 0L)
+		{
+			se_throw(RuntimeError, BadAlloc, unit->len + 1, 0);
+			return 1;
+		}
+		memcpy(symbol, unit->tok, unit->len);
+		symbol[unit->len] = '\0';
+
 		uint16_t id;
 		if (se_ctx_allocid(ctx, &id) != 0)
 		{
@@ -92,171 +397,124 @@ static int se_ctx_action_assign_symbol(se_context_t *ctx, unit_t *unit)
 
 		if (ctxmem->nilsym_size == ctxmem->nilsym_capacity)
 		{
-			const size_t size = sizeof(s2inode_t*) * ctxmem->nilsym_capacity;
-			s2inode_t **pairs = (s2inode_t**)se_ctx_request(ctx, size * 2);
-			if (pairs == 0L)
+			const size_t size = sizeof(uint16_t) * ctxmem->nilsym_capacity;
+			uint16_t *ids = (uint16_t*)se_ctx_request(ctx, size * 2);
+			if (ids == 0L)
 			{
 				se_throw(RuntimeError, BadAlloc, size * 2, 0);
 				return 1;
 			}
 			ctxmem->nilsym_capacity *= 2;
-			memcpy(pairs, ctxmem->nilsym_pairs, size);
-			se_ctx_release(ctx, ctxmem->nilsym_pairs);
-			ctxmem->nilsym_pairs = pairs;
+			memcpy(ids, ctxmem->nilsym_ids, size);
+			se_ctx_release(ctx, ctxmem->nilsym_ids);
+			ctxmem->nilsym_ids = ids;
 		}
-		ctxmem->nilsym_pairs[ctxmem->nilsym_size++] = pair;
+		ctxmem->nilsym_ids[ctxmem->nilsym_size++] = pair->id;
 
-		if (id > ctxmem->idstorage_capacity)
+		if (se_ctx_reserve_idstorage(ctx, id) != 0)
 		{
-			const size_t size = sizeof(se_object_t) * ctxmem->idstorage_capacity;
-			se_object_t *idstorage = (se_object_t*)se_ctx_request(ctx, size * 2);
-			if (idstorage == 0L)
-			{
-				se_throw(RuntimeError, BadAlloc, size * 2, 0);
-				return 1;
-			}
-			ctxmem->idstorage_capacity *= 2;
-			memcpy(idstorage, ctxmem->idstorage, size);
-			memset(idstorage + ctxmem->idstorage_capacity, 0, size);
-			se_ctx_release(ctx, ctxmem->idstorage);
-			ctxmem->idstorage = idstorage;
+			return 1;
 		}
 
 		se_object_t *p = &ctxmem->idstorage[pair->id - 1];
 		*p = wrap2obj(obj, EO_OBJ);
 		p->id = pair->id;
 		p->is_nil = 1;
-	} else
+	}
+
+	if (owned)
 	{
-		se_ctx_release(ctx, symbol);
+		unit->idx = pair->id;
 	}
 
-	se_stack_push(&ctxmem->efs, ctxmem->idstorage[pair->id - 1]);
+	*out = ctxmem->idstorage[pair->id - 1];
 
 	return 0;
 }
 
-static int se_ctx_action_assign_number(se_context_t *ctx, unit_t *unit)
-{	// 立即数分配
-	assert(ctx != 0L);
-	assert(unit != 0L);
-	assert(SE_UNIT_TYPE(*unit) == T_NUMBER);
+// 为SEUS的符号单元查找符号id，新符号在首次执行时加入符号表后记录
+static void se_ctx_intern(ctxmemory_t *ctxmem, seus_t *seus)
+{
+	int i = 0;
+	for (; i < seus->nus; ++i)
+	{
+		unit_t *unit = seus->us + i;
+		if (SE_UNIT_TYPE(*unit) != T_SYMBOL)
+		{
+			continue;
+		}
 
-	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
-	assert(ctxmem != 0L);
+		s2inode_t *pair = hashmap_find_by_span(&ctxmem->symmap, unit->tok, unit->len);
+		unit->idx = pair != 0L && pair->id <= ctxmem->idstorage_capacity ? pair->id : 0;
+	}
 
-	token_t token = unit2tok(*unit);
-	se_number_t num = parse_number(&token), *p;
+	seus->symgen = ctxmem->symgen;
+}
 
-	if (se_ctx_savetmp(ctx, &num, EO_NUM, (void**)&p) != 0)
+// 取数字单元的值，已链接常量池的单元直接读取，否则解析源码
+static se_number_t se_ctx_literal(const seus_t *seus, const unit_t *unit)
+{
+	if (seus != 0L && unit >= seus->us && unit < seus->us + seus->nus
+		&& unit->idx < seus->ncs)
 	{
-		return 1;
+		return seus->cs[unit->idx];
 	}
 
-	se_object_t obj = wrap2obj(p, EO_NUM);
-
-	se_stack_push(&ctxmem->efs, obj);
-
-	return 0;
+	token_t token = unit2tok(*unit);
+	return parse_number(&token);
 }
 
-static int se_ctx_action_bracketval(se_context_t *ctx, unit_t *unit)
-{	// 括号表达式
-	assert(ctx != 0L);
-	assert(unit != 0L);
-	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
-	assert(SE_UNIT_SUBTYPE(*unit) == OP_BRE);
-
+// 取数字单元的值，复制到语句内存中（常量池中的值不可修改）
+static int se_ctx_load_number(se_context_t *ctx, const unit_t *unit, se_object_t *out)
+{
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
-	assert(ctxmem != 0L);
 
-	scopestate_t *state = &ctx->seus.ss[ctxmem->ssp--];
+	se_number_t num = se_ctx_literal(ctxmem->seus, unit), *p;
 
-	if (ctxmem->efs.size <= state->sframe)
-	{
-		se_stack_push(&ctxmem->efs, wrap2obj(0L, EO_NIL));
-	} else
+	if (se_ctx_savenum(ctx, &num, &p) != 0)
 	{
-		int c = ctxmem->vfs.size;
-		ctxmem->vfs.size -= state->accept;
-		for (; c > ctxmem->vfs.size; --c)
-		{
-			se_ctx_mov2blc(ctx, &ctxmem->vfs.stack[c - 1]);
-		}
+		return 1;
 	}
 
+	*out = wrap2obj(p, EO_NUM);
+
 	return 0;
 }
 
-static int se_ctx_action_fncall(se_context_t *ctx, unit_t *unit)
-{	// 函数调用
-	assert(ctx != 0L);
-	assert(unit != 0L);
-	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
-	assert(SE_UNIT_SUBTYPE(*unit) == OP_ARG);
-
-	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
-	assert(ctxmem != 0L);
-
-	scopestate_t *state = &ctx->seus.ss[ctxmem->ssp--];
-
-	int len = ctxmem->efs.size <= state->sframe ? 0 : state->accept + 1;
-	se_array_t as = { 0 };
-	if (len > 0)
-	{
-		as.size = len;
-		as.data = (se_object_t*)se_ctx_request(ctx, as.size * sizeof(se_object_t));
-		as.data[as.size - 1] = se_stack_pop(&ctxmem->efs);
-		for (int c = state->accept; c > 0; --c)
-		{
-			as.data[c - 1] = se_stack_pop(&ctxmem->vfs);
-		}
-	}
-
-	se_object_t obj_fn = se_stack_pop(&ctxmem->efs);
+// 调用函数，参数列表不会脱离函数调用，调用结束后逐个标记过期
+static int se_ctx_call(se_context_t *ctx, se_object_t obj_fn,
+	se_object_t *args, size_t nargs, se_object_t *out)
+{
 	se_object_t *obj = &obj_fn;
 	while (obj->type == EO_OBJ)
 	{
 		obj = (se_object_t*)obj->data;
 	}
 
-	if (obj->type == EO_FUNC)
+	if (obj->type != EO_FUNC)
 	{
-		se_function_t fn = *(se_function_t*)obj->data;
-
-		se_stack_t args = { .stack = as.data, .size = as.size };
-		se_object_t ret = se_call(fn, &args);
+		se_throw(TypeError, NonCallableObject, obj->type, 0);
+		return 1;
+	}
 
-		se_stack_push(&ctxmem->efs, ret);
+	se_function_t fn = *(se_function_t*)obj->data;
 
-		for (int c = 0; c < args.size; ++c)
-		{
-			se_ctx_mov2blc(ctx, &args.stack[c]);
-		}
+	se_stack_t as = { .stack = args, .size = nargs };
+	*out = se_call(fn, &as);
 
-		return !se_caught();
-	} else
+	for (int c = 0; c < as.size; ++c)
 	{
-		se_throw(TypeError, NonCallableObject, obj->type, 0);
-		return 1;
+		se_ctx_mov2blc(ctx, &as.stack[c]);
 	}
-}
 
-static int se_ctx_action_index(se_context_t *ctx, unit_t *unit)
-{	// 数组索引
-	assert(ctx != 0L);
-	assert(unit != 0L);
-	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
-	assert(SE_UNIT_SUBTYPE(*unit) == OP_IDX);
+	return !se_caught();
+}
 
+// 数组索引，数组为引用时结果可写
+static int se_ctx_index(se_context_t *ctx, se_object_t obj_array, se_object_t obj_index, se_object_t *out)
+{
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
-	assert(ctxmem != 0L);
-
-	scopestate_t *state = &ctx->seus.ss[ctxmem->ssp--];
-	ctxmem->vfs.size -= state->accept;
 
-	se_object_t obj_index = se_stack_pop(&ctxmem->efs);
-	se_object_t obj_array = se_stack_pop(&ctxmem->efs);
 	se_object_t *obj;
 
 	obj = &obj_index;
@@ -298,28 +556,459 @@ static int se_ctx_action_index(se_context_t *ctx, unit_t *unit)
 	se_object_t ret;
 	obj = &array->data[index->i];
 
-	int writable = obj_array.type == EO_OBJ;
-	refreq_t req = se_ref_request(obj, writable);
+	int writable = obj_array.type == EO_OBJ;
+	refreq_t req = se_ref_request(obj, writable);
+
+	if (writable)
+	{
+		req.placer = obj;
+	}
+	ret = se_refer(obj, &req);
+
+	while (obj->type == EO_OBJ)
+	{
+		obj = (se_object_t*)obj->data;
+	}
+	--obj->refs;
+
+	if (writable)
+	{
+		if (se_ctx_allocid(ctx, &ret.id) != 0)
+		{
+			se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
+			return 1;
+		}
+	}
+
+	*out = ret;
+
+	return 0;
+}
+
+// 以元素列表创建数组，列表须由se_ctx_reqtmp以TMP_ELEMENTS申请
+static int se_ctx_make_array(se_context_t *ctx, se_array_t as, se_object_t *out)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	int c = 0;
+	for (; c < as.size; ++c)
+	{	// 转换为值引用
+		se_object_t *obj = (se_object_t*)&as.data[c];
+		if (se_ctx_promote(ctx, obj) != 0)
+		{
+			return 1;
+		}
+		refreq_t req = se_ref_request(obj, 0);
+		if (req.placer == 0L)
+		{
+			req.placer = (se_object_t*)se_ctx_reqtmp(ctx, sizeof(se_object_t), TMP_OBJECT, 1);
+			if (req.placer == 0L)
+			{
+				se_throw(RuntimeError, BadAlloc, sizeof(se_object_t), 0);
+				return 1;
+			}
+			memset(req.placer, 0, sizeof(se_object_t));
+			if (se_ctx_allocid(ctx, &req.placer->id) != 0)
+			{
+				se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
+				return 1;
+			}
+		}
+		if (req.reqsize > 0)
+		{
+			req.reqmem = obj->data;
+		}
+		*obj = se_refer(obj, &req);
+		if (se_ctx_allocid(ctx, &obj->id) != 0)
+		{
+			se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
+			return 1;
+		}
+	}
+
+	se_array_t *array = (se_array_t*)se_ctx_reqtmp(ctx, sizeof(se_array_t), TMP_DATA, 1);
+	if (array == 0L)
+	{
+		se_throw(RuntimeError, BadAlloc, sizeof(se_array_t), 0);
+		return 1;
+	}
+	*array = as;
+
+	*out = wrap2obj(array, EO_ARRAY);
+
+	return 0;
+}
+
+// 赋值，结果为左值
+static int se_ctx_assign(se_context_t *ctx, se_object_t lhs, se_object_t rhs, se_object_t *out)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (lhs.type != EO_OBJ || lhs.id == 0)
+	{
+		se_throw(RuntimeError, AssignLeftValue, 0, 0);
+		return 1;
+	}
+
+	se_object_t *obj = &lhs;
+	if (is_writable(obj))
+	{
+		obj = (se_object_t*)obj->data;
+	}
+
+	se_object_t *ref = obj;
+	while (ref->type == EO_OBJ)
+	{
+		ref = (se_object_t*)ref->data;
+	}
+
+	if (lhs.id != rhs.id)
+	{
+		int this_id = lhs.id;
+		if (se_ctx_promote(ctx, &rhs) != 0)
+		{
+			return 1;
+		}
+		--ref->refs;
+		refreq_t req = se_ref_request(&rhs, 0);
+		if (req.placer == 0L)
+		{
+			req.placer = (se_object_t*)se_ctx_reqtmp(ctx, sizeof(se_object_t), TMP_OBJECT, 1);
+			if (req.placer == 0L)
+			{
+				se_throw(RuntimeError, BadAlloc, sizeof(se_object_t), 0);
+				return 1;
+			}
+			memset(req.placer, 0, sizeof(se_object_t));
+			if (se_ctx_allocid(ctx, &req.placer->id) != 0)
+			{
+				se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
+				return 1;
+			}
+		}
+		if (req.reqsize > 0)
+		{
+			req.reqmem = rhs.data;
+		}
+		int obj_id = obj->id;
+		*obj = se_refer(&rhs, &req);
+		obj->id = obj_id;
+		if (!req.writable)
+		{
+			lhs.id = this_id;
+			if (lhs.is_nil)
+			{
+				lhs.is_nil = 0;
+			}
+			ctxmem->idstorage[lhs.id - 1] = lhs;
+		}
+	} else
+	{
+		lhs = rhs;
+	}
+
+	*out = lhs;
+
+	return 0;
+}
+
+// 一元数值运算（act为SE_ACT_SIGN、SE_ACT_LNOT或SE_ACT_NOT）
+static int se_ctx_calc_unary(se_context_t *ctx, int act, int op, se_object_t x, se_object_t *out)
+{
+	se_object_t obj_x;
+
+	if (se_ctx_check_number(&x, &obj_x) != 0)
+	{
+		return 1;
+	}
+
+	se_number_t result, *ret;
+	switch (act)
+	{
+		case SE_ACT_SIGN: se_number_sign(op, (se_number_t*)obj_x.data, &result); break;
+		case SE_ACT_LNOT: se_number_lnot((se_number_t*)obj_x.data, &result); break;
+		case SE_ACT_NOT:
+		{
+			if (se_number_not((se_number_t*)obj_x.data, &result) != 0)
+			{
+				return 1;
+			}
+		}
+		break;
+	}
+
+	if (se_ctx_savenum(ctx, &result, &ret) != 0)
+	{
+		return 1;
+	}
+
+	*out = wrap2obj(ret, EO_NUM);
+
+	return 0;
+}
+
+// 二元数值运算（act为SE_ACT_BASECALC、SE_ACT_COMPARE或SE_ACT_BITOP）
+static int se_ctx_calc_binary(se_context_t *ctx, int act, int op,
+	se_object_t lhs, se_object_t rhs, se_object_t *out)
+{
+	se_object_t obj_x, obj_y;
+
+	if (se_ctx_check_number(&lhs, &obj_x) != 0)
+	{
+		return 1;
+	}
+
+	if (se_ctx_check_number(&rhs, &obj_y) != 0)
+	{
+		return 1;
+	}
+
+	const se_number_t *x = (se_number_t*)obj_x.data, *y = (se_number_t*)obj_y.data;
+
+	se_number_t result, *ret;
+	switch (act)
+	{
+		case SE_ACT_BASECALC:
+		{
+			if (se_number_basecalc(op, x, y, &result) != 0)
+			{
+				return 1;
+			}
+		}
+		break;
+		case SE_ACT_COMPARE: se_number_compare(op, x, y, &result); break;
+		case SE_ACT_BITOP:
+		{
+			if (se_number_bitop(op, x, y, &result) != 0)
+			{
+				return 1;
+			}
+		}
+		break;
+	}
+
+	if (se_ctx_savenum(ctx, &result, &ret) != 0)
+	{
+		return 1;
+	}
+
+	*out = wrap2obj(ret, EO_NUM);
+
+	return 0;
+}
+
+// 运算后赋值
+static int se_ctx_calc_assign(se_context_t *ctx, int op, se_object_t lhs, se_object_t rhs, se_object_t *out)
+{
+	int subtype;
+	switch (op)
+	{
+		case OP_ADD_ASS: subtype = OP_ADD; break;
+		case OP_SUB_ASS: subtype = OP_SUB; break;
+		case OP_MOD_ASS: subtype = OP_MOD; break;
+		case OP_MUL_ASS: subtype = OP_MUL; break;
+		case OP_DIV_ASS: subtype = OP_DIV; break;
+		case OP_LSH_ASS: subtype = OP_LSH; break;
+		case OP_RSH_ASS: subtype = OP_RSH; break;
+		case OP_AND_ASS: subtype = OP_AND; break;
+		case OP_XOR_ASS: subtype = OP_XOR; break;
+		case OP_OR_ASS : subtype = OP_OR;  break;
+	}
+
+	se_object_t result;
+	if (se_ctx_calc_binary(ctx, subtype <= OP_SUB ? SE_ACT_BASECALC : SE_ACT_BITOP,
+		subtype, lhs, rhs, &result) != 0)
+	{
+		return 1;
+	}
+
+	return se_ctx_assign(ctx, lhs, result, out);
+}
+
+// 短路单元（op为OP_LAND_JMP或OP_LOR_JMP），左操作数x已决定结果时将结果写入out并置decided
+// 左操作数不为合法数值时不决定结果，由运算符本身报告异常
+static int se_ctx_decide(se_context_t *ctx, int op, se_object_t x, se_object_t *out, int *decided)
+{
+	*decided = 0;
+
+	const se_object_t *obj = &x;
+	while (obj->type == EO_OBJ)
+	{
+		obj = (const se_object_t*)obj->data;
+	}
+
+	se_number_t result, *ret;
+	if (obj->type != EO_NUM
+		|| !se_number_decide(op == OP_LOR_JMP ? OP_LOR : OP_LAND, (const se_number_t*)obj->data, &result))
+	{
+		return 0;
+	}
+
+	if (se_ctx_savenum(ctx, &result, &ret) != 0)
+	{
+		return 1;
+	}
+
+	*out = wrap2obj(ret, EO_NUM);
+	*decided = 1;
+
+	return 0;
+}
+
+// 取超级指令中的操作数单元，仅被读取（readonly）时常量池中的数字直接引用而不复制
+static int se_ctx_load_operand(se_context_t *ctx, unit_t *unit, int readonly, se_object_t *out)
+{
+	if (SE_UNIT_TYPE(*unit) == T_SYMBOL)
+	{
+		return se_ctx_load_symbol(ctx, unit, out);
+	}
+
+	seus_t *seus = ((ctxmemory_t*)ctx->memory)->seus;
+	if (readonly && unit->idx < seus->ncs)
+	{
+		*out = wrap2obj(&seus->cs[unit->idx], EO_NUM);
+		return 0;
+	}
+
+	return se_ctx_load_number(ctx, unit, out);
+}
+
+// 超级指令中的二元运算（运算符单元的动作为SE_ACT_BASECALC、SE_ACT_COMPARE、SE_ACT_BITOP、
+// SE_ACT_ASSIGN或SE_ACT_CALC_ASS）
+static int se_ctx_apply_binary(se_context_t *ctx, const unit_t *op,
+	se_object_t lhs, se_object_t rhs, se_object_t *out)
+{
+	switch (op->act)
+	{
+		case SE_ACT_ASSIGN:   return se_ctx_assign(ctx, lhs, rhs, out);
+		case SE_ACT_CALC_ASS: return se_ctx_calc_assign(ctx, SE_UNIT_SUBTYPE(*op), lhs, rhs, out);
+		default:              return se_ctx_calc_binary(ctx, op->act, SE_UNIT_SUBTYPE(*op), lhs, rhs, out);
+	}
+}
+
+///-------- stack actions --------
+// 以元素帧栈传递操作数的动作，由unit_t.act经g_actions调用
+// 括号域的帧底部为逗号已接受的值，其后为正在计算的值，域结束时以帧中连续的值为结果
+
+static int se_ctx_action_assign_symbol(se_context_t *ctx, unit_t *unit)
+{	// 符号分配
+	assert(ctx != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_SYMBOL);
+
+	se_object_t obj;
+	if (se_ctx_load_symbol(ctx, unit, &obj) != 0)
+	{
+		return 1;
+	}
+
+	se_stack_push(&ctxmem->efs, obj);
+
+	return 0;
+}
+
+static int se_ctx_action_assign_number(se_context_t *ctx, unit_t *unit)
+{	// 立即数分配
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_NUMBER);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	se_object_t obj;
+	if (se_ctx_load_number(ctx, unit, &obj) != 0)
+	{
+		return 1;
+	}
+
+	se_stack_push(&ctxmem->efs, obj);
+
+	return 0;
+}
+
+static int se_ctx_action_bracketval(se_context_t *ctx, unit_t *unit)
+{	// 括号表达式
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+	assert(SE_UNIT_SUBTYPE(*unit) == OP_BRE);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	scopestate_t *state = &ctxmem->seus->ss[ctxmem->ssp--];
+
+	if (ctxmem->efs.size <= state->sframe)
+	{
+		se_stack_push(&ctxmem->efs, wrap2obj(0L, EO_NIL));
+	} else
+	{	// 取最后一个值，逗号之前的值生命周期结束
+		se_object_t *frame = &ctxmem->efs.stack[state->sframe];
+		int c = state->accept;
+		for (; c > 0; --c)
+		{
+			se_ctx_mov2blc(ctx, &frame[c - 1]);
+		}
+		frame[0] = se_stack_top(&ctxmem->efs);
+		ctxmem->efs.size = state->sframe + 1;
+	}
+
+	return 0;
+}
+
+static int se_ctx_action_fncall(se_context_t *ctx, unit_t *unit)
+{	// 函数调用
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+	assert(SE_UNIT_SUBTYPE(*unit) == OP_ARG);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	scopestate_t *state = &ctxmem->seus->ss[ctxmem->ssp--];
+
+	// 参数为函数之后的帧，不会脱离函数调用，直接在元素帧栈中传递
+	const int len = ctxmem->efs.size - state->sframe;
+	se_object_t *args = &ctxmem->efs.stack[state->sframe];
+
+	se_object_t obj_fn = args[-1], ret;
+	if (se_ctx_call(ctx, obj_fn, len > 0 ? args : 0L, len, &ret) != 0)
+	{
+		return 1;
+	}
+
+	ctxmem->efs.size = state->sframe - 1;
+	se_stack_push(&ctxmem->efs, ret);
+
+	return 0;
+}
+
+static int se_ctx_action_index(se_context_t *ctx, unit_t *unit)
+{	// 数组索引
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+	assert(SE_UNIT_SUBTYPE(*unit) == OP_IDX);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
 
-	if (writable)
-	{
-		req.placer = obj;
-	}
-	ret = se_refer(obj, &req);
+	// 以最后一个值为下标，逗号之前的值随帧一并弹出
+	scopestate_t *state = &ctxmem->seus->ss[ctxmem->ssp--];
 
-	while (obj->type == EO_OBJ)
-	{
-		obj = (se_object_t*)obj->data;
-	}
-	--obj->refs;
+	se_object_t obj_index = se_stack_top(&ctxmem->efs);
+	se_object_t obj_array = ctxmem->efs.stack[state->sframe - 1], ret;
+	ctxmem->efs.size = state->sframe - 1;
 
-	if (writable)
+	if (se_ctx_index(ctx, obj_array, obj_index, &ret) != 0)
 	{
-		if (se_ctx_allocid(ctx, &ret.id) != 0)
-		{
-			se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
-			return 1;
-		}
+		return 1;
 	}
 
 	se_stack_push(&ctxmem->efs, ret);
@@ -337,57 +1026,30 @@ static int se_ctx_action_makearray(se_context_t *ctx, unit_t *unit)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	scopestate_t *state = &ctx->seus.ss[ctxmem->ssp--];
+	scopestate_t *state = &ctxmem->seus->ss[ctxmem->ssp--];
 
-	int len = ctxmem->efs.size <= state->sframe ? 0 : state->accept + 1;
+	// 元素为帧中连续的值
+	const int len = ctxmem->efs.size - state->sframe;
 	se_array_t as = { 0 };
 	if (len > 0)
 	{
 		as.size = len;
-		as.data = (se_object_t*)se_ctx_request(ctx, as.size * sizeof(se_object_t));
-		as.data[as.size - 1] = se_stack_pop(&ctxmem->efs);
-		for (int c = state->accept; c > 0; --c)
-		{
-			as.data[c - 1] = se_stack_pop(&ctxmem->vfs);
-		}
-	}
-
-	int c = 0;
-	for (; c < len; ++c)
-	{	// 转换为值引用
-		se_object_t *obj = (se_object_t*)&as.data[c];
-		refreq_t req = se_ref_request(obj, 0);
-		if (req.placer == 0L)
-		{
-			req.placer = (se_object_t*)se_ctx_request(ctx, sizeof(se_object_t));
-			memset(req.placer, 0, sizeof(se_object_t));
-			if (se_ctx_allocid(ctx, &req.placer->id) != 0)
-			{
-				se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
-				return 1;
-			}
-		}
-		if (req.reqsize > 0)
-		{
-			req.reqmem = obj->data;
-		}
-		*obj = se_refer(obj, &req);
-		if (se_ctx_allocid(ctx, &obj->id) != 0)
+		as.data = (se_object_t*)se_ctx_reqtmp(ctx,
+			as.size * sizeof(se_object_t), TMP_ELEMENTS, as.size);
+		if (as.data == 0L)
 		{
-			se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
+			se_throw(RuntimeError, BadAlloc, as.size * sizeof(se_object_t), 0);
 			return 1;
 		}
+		memcpy(as.data, &ctxmem->efs.stack[state->sframe], as.size * sizeof(se_object_t));
+		ctxmem->efs.size = state->sframe;
 	}
 
-	se_array_t *array = (se_array_t*)se_ctx_request(ctx, sizeof(se_array_t));
-	if (array == 0L)
+	se_object_t ret;
+	if (se_ctx_make_array(ctx, as, &ret) != 0)
 	{
-		se_throw(RuntimeError, BadAlloc, sizeof(se_array_t), 0);
 		return 1;
 	}
-	*array = as;
-
-	se_object_t ret = wrap2obj(array, EO_ARRAY);
 
 	se_stack_push(&ctxmem->efs, ret);
 
@@ -405,68 +1067,19 @@ static int se_ctx_action_assign(se_context_t *ctx, unit_t *unit)
 	assert(ctxmem != 0L);
 
 	se_object_t rhs = se_stack_pop(&ctxmem->efs);
-	se_object_t lhs = se_stack_pop(&ctxmem->efs);
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
 
-	if (lhs.type != EO_OBJ || lhs.id == 0)
+	if (se_ctx_assign(ctx, lhs, rhs, &ret) != 0)
 	{
-		se_throw(RuntimeError, AssignLeftValue, 0, 0);
 		return 1;
 	}
 
-	se_object_t *obj = &lhs;
-	if (is_writable(obj))
-	{
-		obj = (se_object_t*)obj->data;
-	}
-
-	se_object_t *ref = obj;
-	while (ref->type == EO_OBJ)
-	{
-		ref = (se_object_t*)ref->data;
-	}
-
-	if (lhs.id != rhs.id)
-	{
-		int this_id = lhs.id;
-		--ref->refs;
-		refreq_t req = se_ref_request(&rhs, 0);
-		if (req.placer == 0L)
-		{
-			req.placer = (se_object_t*)se_ctx_request(ctx, sizeof(se_object_t));
-			memset(req.placer, 0, sizeof(se_object_t));
-			if (se_ctx_allocid(ctx, &req.placer->id) != 0)
-			{
-				se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
-				return 1;
-			}
-		}
-		if (req.reqsize > 0)
-		{
-			req.reqmem = rhs.data;
-		}
-		int obj_id = obj->id;
-		*obj = se_refer(&rhs, &req);
-		obj->id = obj_id;
-		if (!req.writable)
-		{
-			lhs.id = this_id;
-			if (lhs.is_nil)
-			{
-				lhs.is_nil = 0;
-			}
-			ctxmem->idstorage[lhs.id - 1] = lhs;
-		}
-	} else
-	{
-		lhs = rhs;
-	}
-
-	se_stack_push(&ctxmem->efs, lhs);
+	se_stack_push(&ctxmem->efs, ret);
 
 	return 0;
 }
 
-static int se_ctx_action_mov2vfs(se_context_t *ctx, unit_t *unit)
+static int se_ctx_action_comma(se_context_t *ctx, unit_t *unit)
 {	// 逗号表达式
 	assert(ctx != 0L);
 	assert(unit != 0L);
@@ -476,17 +1089,8 @@ static int se_ctx_action_mov2vfs(se_context_t *ctx, unit_t *unit)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	scopestate_t *state = &ctx->seus.ss[ctxmem->ssp];
-	se_stack_push(&ctxmem->vfs, ctxmem->efs.stack[state->sframe]);
-
-	int c = state->sframe;
-	for (; c < ctxmem->efs.size - 1; ++c)
-	{
-		ctxmem->efs.stack[c] = ctxmem->efs.stack[c + 1];
-	}
-
-	--ctxmem->efs.size;
-	++state->accept;
+	// 帧的底部为已接受的值，其后为正在计算的值；左操作数原地计入已接受的值
+	++ctxmem->seus->ss[ctxmem->ssp].accept;
 
 	return 0;
 }
@@ -521,197 +1125,72 @@ static int se_ctx_action_exparray(se_context_t *ctx, unit_t *unit)
 		return 1;
 	}
 
-	scopestate_t *state = &ctx->seus.ss[ctxmem->ssp];
-	se_stack_push(&ctxmem->efs, array->data[array->size - 1]);
-	for (int c = 0; c < array->size - 1; ++c)
-	{
-		se_stack_push(&ctxmem->vfs, array->data[c]);
-	}
-	state->accept += array->size - 1;
-
-	return 0;
-}
-
-static int se_ctx_action_sign(se_context_t *ctx, unit_t *unit)
-{	// 正负符号
-	assert(ctx != 0L);
-	assert(unit != 0L);
-	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
-	assert(SE_UNIT_SUBTYPE(*unit) == OP_PL
-		|| SE_UNIT_SUBTYPE(*unit) == OP_NL);
-
-	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
-	assert(ctxmem != 0L);
-
-	se_object_t lhs = se_stack_pop(&ctxmem->efs), obj_x;
-
-	if (se_ctx_check_number(&lhs, &obj_x) != 0)
-	{
-		return 1;
-	}
-
-	se_number_t *x;
-	if (se_ctx_savetmp(ctx, obj_x.data, EO_NUM, (void**)&x) != 0)
-	{
-		return 1;
-	}
-
-	if (SE_UNIT_SUBTYPE(*unit) == OP_NL)
-	{
-		if (x->type == EN_FLT)
-		{
-			x->f = -x->f;
-		} else
-		{
-			x->inf = x->i < 0 && -x->i < 0;
-			x->i = -x->i;
-		}
-	}
-
-	se_stack_push(&ctxmem->efs, wrap2obj(x, EO_NUM));
-
-	return 0;
-}
-
-static int se_ctx_action_basecalc(se_context_t *ctx, unit_t *unit)
-{	// 基础五则运算
-	assert(ctx != 0L);
-	assert(unit != 0L);
-	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
-	assert(SE_UNIT_SUBTYPE(*unit) == OP_ADD
-		|| SE_UNIT_SUBTYPE(*unit) == OP_SUB
-		|| SE_UNIT_SUBTYPE(*unit) == OP_MOD
-		|| SE_UNIT_SUBTYPE(*unit) == OP_MUL
-		|| SE_UNIT_SUBTYPE(*unit) == OP_DIV);
-
-	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
-	assert(ctxmem != 0L);
-
-	se_object_t rhs = se_stack_pop(&ctxmem->efs), obj_y;
-	se_object_t lhs = se_stack_pop(&ctxmem->efs), obj_x;
-
-	if (se_ctx_check_number(&lhs, &obj_x) != 0)
-	{
-		return 1;
-	}
-
-	if (se_ctx_check_number(&rhs, &obj_y) != 0)
-	{
-		return 1;
-	}
-
-	se_number_t *x = (se_number_t*)obj_x.data;
-	se_number_t *y = (se_number_t*)obj_y.data;
-
-	const int op = SE_UNIT_SUBTYPE(*unit);
-	int useflt = x->type == EN_FLT || y->type == EN_FLT;
+	// 末元素作为值留在栈顶，其余元素插入已接受的值之后，正在计算的值随之上移
+	scopestate_t *state = &ctxmem->seus->ss[ctxmem->ssp];
+	const int at = state->sframe + state->accept;
+	const int nwork = ctxmem->efs.size - at;
 
-	if (useflt && op == OP_MOD)
+	int c = 0;
+	for (; c < array->size; ++c)
 	{
-		se_throw(TypeError, ModuloWithFloat, 0, 0);
-		return 1;
+		se_stack_push(&ctxmem->efs, wrap2obj(0L, EO_NIL));
 	}
 
-	int32_t ix = x->i;
-	int32_t iy = y->i;
-	double  fx = x->type == EN_FLT ? x->f : ix * 1.0;
-	double  fy = y->type == EN_FLT ? y->f : iy * 1.0;
-
-	int32_t ri;
-	double  rf;
-
-	int inf = 0;
+	se_object_t *frame = &ctxmem->efs.stack[at];
+	memmove(frame + array->size - 1, frame, nwork * sizeof(se_object_t));
+	memcpy(frame, array->data, (array->size - 1) * sizeof(se_object_t));
+	frame[array->size - 1 + nwork] = array->data[array->size - 1];
+	state->accept += array->size - 1;
 
-	switch (op)
-	{
-		case OP_ADD:
-		{
-			if (useflt)
-			{
-				rf = fx + fy;
-			} else
-			{
-				ri = ix + iy;
-				inf = (ix & iy & ~ri) >> 31;
-			}
-		}
-		break;
-		case OP_SUB:
-		{
-			if (useflt)
-			{
-				rf = fx - fy;
-			} else
-			{
-				ri = ix - iy;
-				inf = (ix & ~iy & ~ri) >> 31;
-			}
-		}
-		break;
-		case OP_MOD:
-		{
-			if (iy == 0)
-			{
-				se_throw(RuntimeError, IntDivOrModByZero, 0, 0);
-				return 1;
-			}
-			ri = ix % iy;
-		}
-		break;
-		case OP_MUL:
-		{
-			if (useflt)
-			{
-				rf = fx * fy;
-			} else
-			{
-				ri = ix * iy;
-				if (iy != 0)
-				{
-					inf = ri / iy != ix;
-				}
-			}
-		}
-		break;
-		case OP_DIV:
-		{
-			if (!useflt && iy == 0)
-			{
-				se_throw(RuntimeError, IntDivOrModByZero, 0, 0);
-				return 1;
-			}
-			if (useflt)
-			{
-				rf = fx / fy;
-			} else
-			{
-				ri = ix / iy;
-			}
-		}
-		break;
-	}
+	return 0;
+}
 
-	se_number_t result, *ret;
-	if (useflt)
-	{
-		result.f = rf;
-		result.type = EN_FLT;
-		result.inf = isinf(rf);
-		result.nan = isnan(rf);
-	} else
+static int se_ctx_action_sign(se_context_t *ctx, unit_t *unit)
+{	// 正负符号
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+	assert(SE_UNIT_SUBTYPE(*unit) == OP_PL
+		|| SE_UNIT_SUBTYPE(*unit) == OP_NL);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
+
+	if (se_ctx_calc_unary(ctx, SE_ACT_SIGN, SE_UNIT_SUBTYPE(*unit), lhs, &ret) != 0)
 	{
-		result.i = ri;
-		result.type = EN_DEC;
-		result.inf = inf;
-		result.nan = 0;
+		return 1;
 	}
 
-	if (se_ctx_savetmp(ctx, &result, EO_NUM, (void**)&ret) != 0)
+	se_stack_push(&ctxmem->efs, ret);
+
+	return 0;
+}
+
+static int se_ctx_action_basecalc(se_context_t *ctx, unit_t *unit)
+{	// 基础五则运算
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+	assert(SE_UNIT_SUBTYPE(*unit) == OP_ADD
+		|| SE_UNIT_SUBTYPE(*unit) == OP_SUB
+		|| SE_UNIT_SUBTYPE(*unit) == OP_MOD
+		|| SE_UNIT_SUBTYPE(*unit) == OP_MUL
+		|| SE_UNIT_SUBTYPE(*unit) == OP_DIV);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	se_object_t rhs = se_stack_pop(&ctxmem->efs);
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
+
+	if (se_ctx_calc_binary(ctx, SE_ACT_BASECALC, SE_UNIT_SUBTYPE(*unit), lhs, rhs, &ret) != 0)
 	{
 		return 1;
 	}
 
-	se_stack_push(&ctxmem->efs, wrap2obj(ret, EO_NUM));
+	se_stack_push(&ctxmem->efs, ret);
 
 	return 0;
 }
@@ -734,48 +1213,14 @@ static int se_ctx_action_compare(se_context_t *ctx, unit_t *unit)
 	assert(ctxmem != 0L);
 
 	se_object_t rhs = se_stack_pop(&ctxmem->efs);
-	se_object_t lhs = se_stack_pop(&ctxmem->efs);
-
-	se_object_t obj_x, obj_y;
-
-	if (se_ctx_check_number(&lhs, &obj_x) != 0)
-	{
-		return 1;
-	}
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
 
-	if (se_ctx_check_number(&rhs, &obj_y) != 0)
-	{
-		return 1;
-	}
-
-	se_number_t *x = (se_number_t*)obj_x.data, *y = (se_number_t*)obj_y.data;
-	se_number_t result, *ret;
-	result.type = EN_DEC;
-	result.inf  = 0;
-	result.nan  = 0;
-
-	switch (SE_UNIT_SUBTYPE(*unit))
-	{
-#define CMP(L, OP, R) \
-(	((L)->type == EN_FLT ? (L)->f : (L)->i) OP  \
-	((R)->type == EN_FLT ? (R)->f : (R)->i)	)
-		case OP_GTR:  result.i = CMP(x,  >, y); break;
-		case OP_GEQ:  result.i = CMP(x, >=, y); break;
-		case OP_LSS:  result.i = CMP(x,  <, y); break;
-		case OP_LEQ:  result.i = CMP(x, <=, y); break;
-		case OP_EQU:  result.i = CMP(x, ==, y); break;
-		case OP_NEQ:  result.i = CMP(x, !=, y); break;
-		case OP_LAND: result.i = CMP(x, &&, y); break;
-		case OP_LOR:  result.i = CMP(x, ||, y); break;
-#undef CMP
-	}
-
-	if (se_ctx_savetmp(ctx, &result, EO_NUM, (void**)&ret) != 0)
+	if (se_ctx_calc_binary(ctx, SE_ACT_COMPARE, SE_UNIT_SUBTYPE(*unit), lhs, rhs, &ret) != 0)
 	{
 		return 1;
 	}
 
-	se_stack_push(&ctxmem->efs, wrap2obj(ret, EO_NUM));
+	se_stack_push(&ctxmem->efs, ret);
 
 	return 0;
 }
@@ -790,26 +1235,14 @@ static int se_ctx_action_logical_not(se_context_t *ctx, unit_t *unit)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	se_object_t lhs = se_stack_pop(&ctxmem->efs);
-	se_object_t obj_x;
-
-	if (se_ctx_check_number(&lhs, &obj_x) != 0)
-	{
-		return 1;
-	}
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
 
-	se_number_t *x = (se_number_t*)obj_x.data, *ret;
-	if (se_ctx_savetmp(ctx, x, EO_NUM, (void**)&ret) != 0)
+	if (se_ctx_calc_unary(ctx, SE_ACT_LNOT, OP_LNOT, lhs, &ret) != 0)
 	{
 		return 1;
 	}
 
-	ret->i = x->type == EN_FLT ? !x->f : !x->i;
-	ret->type = EN_DEC;
-	ret->inf  = 0;
-	ret->nan  = 0;
-
-	se_stack_push(&ctxmem->efs, wrap2obj(ret, EO_NUM));
+	se_stack_push(&ctxmem->efs, ret);
 
 	return 0;
 }
@@ -824,32 +1257,14 @@ static int se_ctx_action_bitwise_not(se_context_t *ctx, unit_t *unit)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	se_object_t lhs = se_stack_pop(&ctxmem->efs);
-	se_object_t obj_x;
-
-	if (se_ctx_check_number(&lhs, &obj_x) != 0)
-	{
-		return 1;
-	}
-
-	se_number_t *x = (se_number_t*)obj_x.data, *ret;
-	if (x->type == EN_FLT)
-	{
-		se_throw(TypeError, BitwiseOpWithFloat, 0, 0);
-		return 1;
-	}
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
 
-	if (se_ctx_savetmp(ctx, x, EO_NUM, (void**)&ret) != 0)
+	if (se_ctx_calc_unary(ctx, SE_ACT_NOT, OP_NOT, lhs, &ret) != 0)
 	{
 		return 1;
 	}
 
-	ret->i    = ~x->i;
-	ret->type = x->type;
-	ret->inf  = 0;
-	ret->nan  = 0;
-
-	se_stack_push(&ctxmem->efs, wrap2obj(ret, EO_NUM));
+	se_stack_push(&ctxmem->efs, ret);
 
 	return 0;
 }
@@ -868,119 +1283,334 @@ static int se_ctx_action_binary_bitop(se_context_t *ctx, unit_t *unit)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	se_object_t rhs = se_stack_pop(&ctxmem->efs), obj_y;
-	se_object_t lhs = se_stack_pop(&ctxmem->efs), obj_x;
+	se_object_t rhs = se_stack_pop(&ctxmem->efs);
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
 
-	if (se_ctx_check_number(&lhs, &obj_x) != 0)
+	if (se_ctx_calc_binary(ctx, SE_ACT_BITOP, SE_UNIT_SUBTYPE(*unit), lhs, rhs, &ret) != 0)
 	{
 		return 1;
 	}
 
-	if (se_ctx_check_number(&rhs, &obj_y) != 0)
+	se_stack_push(&ctxmem->efs, ret);
+
+	return 0;
+}
+
+static int se_ctx_action_calc_and_ass(se_context_t *ctx, unit_t *unit)
+{	// 运算后赋值
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+	assert(SE_UNIT_SUBTYPE(*unit) == OP_ADD_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_SUB_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_MOD_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_MUL_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_DIV_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_LSH_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_RSH_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_AND_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_XOR_ASS
+		|| SE_UNIT_SUBTYPE(*unit) == OP_OR_ASS);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	se_object_t rhs = se_stack_pop(&ctxmem->efs);
+	se_object_t lhs = se_stack_pop(&ctxmem->efs), ret;
+
+	if (se_ctx_calc_assign(ctx, SE_UNIT_SUBTYPE(*unit), lhs, rhs, &ret) != 0)
 	{
 		return 1;
 	}
 
-	se_number_t *x = (se_number_t*)obj_x.data;
-	se_number_t *y = (se_number_t*)obj_y.data;
+	se_stack_push(&ctxmem->efs, ret);
+
+	return 0;
+}
 
-	if (x->type == EN_FLT)
+static int se_ctx_action_jump(se_context_t *ctx, unit_t *unit)
+{	// 逻辑与、逻辑或的短路
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+	assert(SE_UNIT_SUBTYPE(*unit) == OP_LAND_JMP
+		|| SE_UNIT_SUBTYPE(*unit) == OP_LOR_JMP);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	// 左操作数留在栈顶，决定结果时以结果替换并跳过右操作数与运算符
+	se_object_t *lhs = &ctxmem->efs.stack[ctxmem->efs.size - 1];
+
+	int decided;
+	if (se_ctx_decide(ctx, SE_UNIT_SUBTYPE(*unit), *lhs, lhs, &decided) != 0)
 	{
-		se_throw(TypeError, BitwiseOpWithFloat, 0, 0);
 		return 1;
 	}
 
-	if (y->type == EN_FLT)
+	return decided ? SE_ACT_SKIP(unit->idx) : 0;
+}
+
+static int se_ctx_action_load_op(se_context_t *ctx, unit_t *unit)
+{	// 超级指令：操作数与二元运算，结果替换栈顶的左操作数
+	assert(ctx != 0L);
+	assert(unit != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	se_object_t *lhs = &ctxmem->efs.stack[ctxmem->efs.size - 1], rhs;
+
+	if (se_ctx_load_operand(ctx, unit, unit[1].act != SE_ACT_ASSIGN, &rhs) != 0)
 	{
-		se_throw(TypeError, BitwiseOpWithFloat, 0, 0);
 		return 1;
 	}
 
-	int32_t t;
-	switch (SE_UNIT_SUBTYPE(*unit))
+	if (se_ctx_apply_binary(ctx, unit + 1, *lhs, rhs, lhs) != 0)
 	{
-		case OP_LSH: t = x->i << y->i; break;
-		case OP_RSH: t = x->i >> y->i; break;
-		case OP_AND: t = x->i  & y->i; break;
-		case OP_XOR: t = x->i  ^ y->i; break;
-		case OP_OR:  t = x->i  | y->i; break;
+		return 1;
 	}
 
-	se_number_t result, *ret;
-	result.i    = t;
-	result.type = x->type;
-	result.inf  = 0;
-	result.nan  = 0;
+	return SE_ACT_SKIP(1);
+}
+
+static int se_ctx_action_load2_op(se_context_t *ctx, unit_t *unit)
+{	// 超级指令：两个操作数与二元运算，操作数不经过元素帧栈
+	assert(ctx != 0L);
+	assert(unit != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	const int readonly = unit[2].act != SE_ACT_ASSIGN;
+
+	se_object_t lhs, rhs, ret;
+	if (se_ctx_load_operand(ctx, unit, readonly, &lhs) != 0
+		|| se_ctx_load_operand(ctx, unit + 1, readonly, &rhs) != 0)
+	{
+		return 1;
+	}
 
-	if (se_ctx_savetmp(ctx, &result, EO_NUM, (void**)&ret) != 0)
+	if (se_ctx_apply_binary(ctx, unit + 2, lhs, rhs, &ret) != 0)
 	{
 		return 1;
 	}
 
-	se_stack_push(&ctxmem->efs, wrap2obj(ret, EO_NUM));
+	se_stack_push(&ctxmem->efs, ret);
 
-	return 0;
+	return SE_ACT_SKIP(2);
 }
 
-static int se_ctx_action_calc_and_ass(se_context_t *ctx, unit_t *unit)
-{	// 运算后赋值
+static int se_ctx_action_scoped(se_context_t *ctx, unit_t *unit)
+{	// 超级指令：只包含一个操作数的括号、函数调用或数组索引，不写入括号域状态
 	assert(ctx != 0L);
 	assert(unit != 0L);
 	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
-	assert(SE_UNIT_SUBTYPE(*unit) == OP_ADD_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_SUB_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_MOD_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_MUL_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_DIV_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_LSH_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_RSH_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_AND_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_XOR_ASS
-		|| SE_UNIT_SUBTYPE(*unit) == OP_OR_ASS);
 
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	se_object_t lhs = ctxmem->efs.stack[ctxmem->efs.size - 2];
+	const unit_t *end = unit + 2;
 
-	unit_t dummy;
+	se_object_t x, ret;
+	if (se_ctx_load_operand(ctx, unit + 1, end->act == SE_ACT_INDEX, &x) != 0)
+	{
+		return 1;
+	}
+
+	switch (end->act)
+	{
+		case SE_ACT_FNCALL:
+		{
+			se_object_t obj_fn = se_stack_pop(&ctxmem->efs);
+			if (se_ctx_call(ctx, obj_fn, &x, 1, &ret) != 0)
+			{
+				return 1;
+			}
+		}
+		break;
+		case SE_ACT_INDEX:
+		{
+			se_object_t obj_array = se_stack_pop(&ctxmem->efs);
+			if (se_ctx_index(ctx, obj_array, x, &ret) != 0)
+			{
+				return 1;
+			}
+		}
+		break;
+		default:
+		{
+			ret = x;
+		}
+		break;
+	}
+
+	se_stack_push(&ctxmem->efs, ret);
+
+	return SE_ACT_SKIP(2);
+}
+
+static int se_ctx_action_scope(se_context_t *ctx, unit_t *unit)
+{	// 压入新的括号域
+	assert(ctx != 0L);
+	assert(unit != 0L);
+	assert(SE_UNIT_TYPE(*unit) == T_OPERATOR);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	ctxmem->seus->ss[++ctxmem->ssp] = (scopestate_t){ (int)ctxmem->efs.size, 0 };
+
+	return 0;
+}
+
+static int se_ctx_action_nop(se_context_t *ctx, unit_t *unit)
+{	// 无动作
+	(void)ctx;
+	(void)unit;
+	return 0;
+}
+
+typedef int (*se_ctx_action_t)(se_context_t*, unit_t*);
+
+static const se_ctx_action_t g_actions[SE_ACT_COUNT] =
+{
+	se_ctx_action_nop,
+	se_ctx_action_assign_symbol,
+	se_ctx_action_assign_number,
+	se_ctx_action_scope,
+	se_ctx_action_bracketval,
+	se_ctx_action_fncall,
+	se_ctx_action_index,
+	se_ctx_action_makearray,
+	se_ctx_action_assign,
+	se_ctx_action_comma,
+	se_ctx_action_exparray,
+	se_ctx_action_sign,
+	se_ctx_action_basecalc,
+	se_ctx_action_compare,
+	se_ctx_action_logical_not,
+	se_ctx_action_bitwise_not,
+	se_ctx_action_binary_bitop,
+	se_ctx_action_calc_and_ass,
+	se_ctx_action_jump,
+	se_ctx_action_load_op,
+	se_ctx_action_load2_op,
+	se_ctx_action_scoped,
+};
+
+// 解析单元对应的动作编号
+static int se_ctx_resolve_action(const unit_t *unit)
+{
+	switch (SE_UNIT_TYPE(*unit))
+	{
+		case T_SYMBOL: return SE_ACT_SYMBOL;
+		case T_NUMBER: return SE_ACT_NUMBER;
+		case T_OPERATOR: break;
+		default: return SE_ACT_NOP;
+	}
 
-	int subtype;
 	switch (SE_UNIT_SUBTYPE(*unit))
 	{
-		case OP_ADD_ASS: subtype = OP_ADD; break;
-		case OP_SUB_ASS: subtype = OP_SUB; break;
-		case OP_MOD_ASS: subtype = OP_MOD; break;
-		case OP_MUL_ASS: subtype = OP_MUL; break;
-		case OP_DIV_ASS: subtype = OP_DIV; break;
-		case OP_LSH_ASS: subtype = OP_LSH; break;
-		case OP_RSH_ASS: subtype = OP_RSH; break;
-		case OP_AND_ASS: subtype = OP_AND; break;
-		case OP_XOR_ASS: subtype = OP_XOR; break;
-		case OP_OR_ASS : subtype = OP_OR;  break;
+		case OP_BRE_S:
+		case OP_ARG_S:
+		case OP_IDX_S:
+		case OP_ARR_S:   return SE_ACT_SCOPE;
+		case OP_BRE:     return SE_ACT_BRACKET;
+		case OP_ARG:     return SE_ACT_FNCALL;
+		case OP_IDX:     return SE_ACT_INDEX;
+		case OP_ARR:     return SE_ACT_MAKEARRAY;
+		case OP_ASS:     return SE_ACT_ASSIGN;
+		case OP_CME:     return SE_ACT_COMMA;
+		case OP_EPA:     return SE_ACT_EXPARRAY;
+		case OP_PL:
+		case OP_NL:      return SE_ACT_SIGN;
+		case OP_ADD:
+		case OP_SUB:
+		case OP_MOD:
+		case OP_MUL:
+		case OP_DIV:     return SE_ACT_BASECALC;
+		case OP_GTR:
+		case OP_GEQ:
+		case OP_LSS:
+		case OP_LEQ:
+		case OP_EQU:
+		case OP_NEQ:
+		case OP_LAND:
+		case OP_LOR:     return SE_ACT_COMPARE;
+		case OP_LNOT:    return SE_ACT_LNOT;
+		case OP_NOT:     return SE_ACT_NOT;
+		case OP_LSH:
+		case OP_RSH:
+		case OP_AND:
+		case OP_XOR:
+		case OP_OR:      return SE_ACT_BITOP;
+		case OP_ADD_ASS:
+		case OP_SUB_ASS:
+		case OP_MOD_ASS:
+		case OP_MUL_ASS:
+		case OP_DIV_ASS:
+		case OP_LSH_ASS:
+		case OP_RSH_ASS:
+		case OP_AND_ASS:
+		case OP_XOR_ASS:
+		case OP_OR_ASS:  return SE_ACT_CALC_ASS;
+		case OP_LAND_JMP:
+		case OP_LOR_JMP: return SE_ACT_JUMP;
+		default:         return SE_ACT_NOP;
 	}
+}
 
-	dummy = tok2unit((token_t){ .type = T_OPERATOR, .sub_type = subtype });
-	if (subtype <= OP_SUB)
+// 单元自身的动作，超级指令的首单元按其类型解析
+static inline int se_ctx_base_action(const unit_t *unit)
+{
+	return unit->act != SE_ACT_NOP && unit->act < SE_ACT_FUSED
+		? unit->act : se_ctx_resolve_action(unit);
+}
+
+// 为SEUS的每个单元链接动作，执行时直接调用而不再解码单元类型
+// 同时将数字字面量解码到常量池，执行时不再重复解析
+static void se_ctx_link(seus_t *seus)
+{
+	int i = 0, nnum = 0;
+	for (; i < seus->nus; ++i)
 	{
-		if  (se_ctx_action_basecalc(ctx, &dummy) != 0)
+		seus->us[i].act = se_ctx_resolve_action(seus->us + i);
+		if (seus->us[i].act == SE_ACT_NUMBER)
 		{
-			return 1;
+			++nnum;
 		}
-	} else if (se_ctx_action_binary_bitop(ctx, &dummy) != 0)
-	{
-		return 1;
 	}
 
-	se_object_t rhs = se_stack_pop(&ctxmem->efs);
-	se_stack_push(&ctxmem->efs, lhs);
-	se_stack_push(&ctxmem->efs, rhs);
+	seus->ncs = 0;
+	seus->fusegen = 0;
+	if (nnum == 0)
+	{
+		return;
+	}
 
-	dummy = tok2unit((token_t){ .type = T_OPERATOR, .sub_type = OP_ASS });
-	if (se_ctx_action_assign(ctx, &dummy) != 0)
+	const size_t size = nnum * sizeof(se_number_t);
+	if (seus->cs == 0L || se_msize(seus->cs) < size)
 	{
-		return 1;
+		if (seus->cs != 0L)
+		{
+			se_free(seus->cs);
+		}
+		seus->cs = (se_number_t*)se_alloc(size);
+		if (seus->cs == 0L)
+		{	// 常量池申请失败时执行期逐次解析
+			return;
+		}
 	}
 
-	return 0;
-}
\ No newline at end of file
+	for (i = 0; i < seus->nus; ++i)
+	{
+		unit_t *unit = seus->us + i;
+		if (unit->act == SE_ACT_NUMBER)
+		{
+			token_t token = unit2tok(*unit);
+			seus->cs[seus->ncs] = parse_number(&token);
+			unit->idx = seus->ncs++;
+		}
+	}
+}
@@ -1,54 +1,199 @@
 #include <se/alloc.h>
+#include <se/thread.h>
 #include <malloc.h>
 #include <string.h>
 #include <assert.h>
 
 #define MEM_UNIT_SIZE 8 // 内存单元大小（字节）
 #define MEM_INIT_SIZE 32 // 初始内存池大小（内存单元）
+#define MEM_CLASS_COUNT 32 // 小内存尺寸类别数量（按内存单元递增）
+#define MEM_CLASS_MAX (MEM_CLASS_COUNT * MEM_UNIT_SIZE) // 使用空闲链表的最大尺寸（字节）
+
+// 尺寸向上对齐至内存单元
+#define MEM_ROUND(size) (((size) + MEM_UNIT_SIZE - 1) & ~(size_t)(MEM_UNIT_SIZE - 1))
+// 小内存的尺寸类别
+#define MEM_CLASS(size) ((size) / MEM_UNIT_SIZE - 1)
 
 typedef struct memblock_s
 {
 	size_t  size;            // 内存池大小（单元数量）
-	size_t  used;            // 已分配的内存段数量（内存段清零时当前指针指向初位置）
+	size_t  used;            // 使用中的内存段数量（内存段清零时当前指针指向初位置）
+	size_t  nfree;           // 位于空闲链表中的小内存段数量（清零前内存块不可重置）
+	uint8_t *base;           // 内存块起始位置
 	uint8_t *cur;            // 内存块当前位置
 	uint8_t *end;            // 内存块末尾
+	uint32_t index;          // 内存块在索引表中的下标
 	struct memblock_s *next; // 下一个内存块
 } memblock_t;
 
+// 内存段头，记录内存段尺寸与所属内存块的索引，释放时据此直接定位内存块
+typedef struct memhead_s
+{
+	uint32_t size;  // 内存段尺寸（字节）
+	uint32_t block; // 所属内存块下标
+} memhead_t;
+
+#define MEM_HEAD(p) ((memhead_t*)(p) - 1)
+
+// 空闲小内存段，复用内存段本身的空间作为链表节点
+typedef struct memfree_s
+{
+	struct memfree_s *next;
+} memfree_t;
+
 typedef struct mempool_s
 {
 	memblock_t *head;       // 初始内存块
 	memblock_t *current;    // 当前内存块
+	memblock_t **blocks;    // 内存块索引表（已归还的内存块留空）
+	uint32_t nblocks;       // 索引表长度
+	uint32_t capacity;      // 索引表容量
+	memfree_t *freelist[MEM_CLASS_COUNT]; // 按尺寸分类的空闲小内存段（段头保留尺寸）
 	size_t id;              // 内存池编号
 	struct mempool_s *next; // 下一个内存池
 } mempool_t;
 
-static int g_current_allocator      = 0;  // 使用标准库malloc/free
-static mempool_t *g_mempool_root    = 0L; // 内存池链表
-static mempool_t *g_mempool_current = 0L; // 当前内存池指针
+// 内存池查找缓存，避免每次切换内存分配器时加锁遍历链表
+typedef struct poolcache_s
+{
+	int id;          // 内存池编号（0表示空）
+	long generation; // 缓存时的内存池代数
+	mempool_t *pool; // 内存池指针
+} poolcache_t;
 
-static size_t se_msize_by_allocator(void *mptr)
+#define MEM_CACHE_SIZE 4 // 每个线程缓存的内存池数量
+
+// 当前内存分配器为线程局部状态，各线程可同时使用不同的内存池
+static SE_THREAD_LOCAL int g_current_allocator      = 0;  // 使用标准库malloc/free
+static SE_THREAD_LOCAL mempool_t *g_mempool_current = 0L; // 当前内存池指针
+static SE_THREAD_LOCAL poolcache_t g_pool_cache[MEM_CACHE_SIZE];
+static SE_THREAD_LOCAL unsigned g_pool_cache_next;
+
+static mempool_t *g_mempool_root        = 0L; // 内存池链表（由g_mempool_lock保护）
+static se_spinlock_t g_mempool_lock     = SE_SPINLOCK_INIT;
+static se_atomic_t g_mempool_generation = 0;  // 销毁内存池时递增，使各线程的查找缓存失效
+
+// 创建内存块并登记到内存池的索引表
+static memblock_t* se_block_create(mempool_t *pool, size_t size)
 {
-	assert(g_current_allocator != 0);
-	assert(g_mempool_current != 0L);
+	uint32_t index = 0;
+	while (index < pool->nblocks && pool->blocks[index] != 0L)
+	{	// 优先复用已归还内存块的下标
+		++index;
+	}
 
-	memblock_t *mp = g_mempool_current->head;
+	if (index == pool->capacity)
+	{
+		pool->capacity = pool->capacity == 0 ? 8 : pool->capacity * 2;
+		pool->blocks = (memblock_t**)realloc(pool->blocks, sizeof(memblock_t*) * pool->capacity);
+		assert(pool->blocks != 0L);
+	}
+
+	memblock_t *mp = (memblock_t*)malloc(sizeof(memblock_t));
 	assert(mp != 0L);
-	assert(mp->size != 0);
 
-	uint8_t *p = (uint8_t*)mptr;
+	mp->size  = size;
+	mp->used  = 0;
+	mp->nfree = 0;
+	mp->base  = (uint8_t*)malloc(mp->size * MEM_UNIT_SIZE);
+	mp->cur   = mp->base;
+	mp->end   = mp->base + mp->size * MEM_UNIT_SIZE - 1;
+	mp->index = index;
+	mp->next  = 0L;
+	assert(mp->base != 0L);
+
+	pool->blocks[index] = mp;
+	if (index == pool->nblocks)
+	{
+		++pool->nblocks;
+	}
+
+	return mp;
+}
+
+static void se_block_destroy(mempool_t *pool, memblock_t *mp)
+{
+	pool->blocks[mp->index] = 0L;
+	free(mp->base);
+	free(mp);
+}
+
+// 由内存段头定位所属内存块
+static memblock_t* se_block_of(void *mptr)
+{
+	const memhead_t *head = MEM_HEAD(mptr);
+	assert(head->block < g_mempool_current->nblocks);
+
+	memblock_t *mp = g_mempool_current->blocks[head->block];
+	assert(mp != 0L);
+	assert((uint8_t*)mptr >= mp->base + sizeof(memhead_t) && (uint8_t*)mptr <= mp->end);
+
+	return mp;
+}
 
-	while (mp != 0L)
+// 将空闲内存块（无使用中的内存段）中的小内存段移出空闲链表并重置这些内存块，返回重置的内存块数
+// 空闲的内存块随后可供任意尺寸复用，或由se_trim_by_allocator归还
+// 非force时仅在可重置的内存不少于需遍历的空闲链表时进行，遍历的开销由重置的内存分摊
+static size_t se_pool_reclaim(mempool_t *pool, int force)
+{
+	size_t count = 0, idle = 0, nfree = 0;
+
+	memblock_t *mp = pool->head;
+	for (; mp != 0L; mp = mp->next)
 	{
-		const size_t bytelen = mp->size * MEM_UNIT_SIZE;
-		if (mp->end - p + 1 <= bytelen - sizeof(size_t))
+		nfree += mp->nfree;
+		if (mp->used == 0 && mp->nfree > 0)
 		{
-			return *((size_t*)p - 1);
+			++count;
+			idle += mp->size;
 		}
-		mp = mp->next;
 	}
 
-	return 0;
+	if (count == 0 || (!force && idle < nfree))
+	{
+		return 0;
+	}
+
+	int c = 0;
+	for (; c < MEM_CLASS_COUNT; ++c)
+	{
+		memfree_t **link = &pool->freelist[c];
+		while (*link != 0L)
+		{
+			memblock_t *owner = pool->blocks[MEM_HEAD(*link)->block];
+			if (owner->used == 0)
+			{
+				--owner->nfree;
+				*link = (*link)->next;
+			} else
+			{
+				link = &(*link)->next;
+			}
+		}
+	}
+
+	for (mp = pool->head; mp != 0L; mp = mp->next)
+	{
+		if (mp->used == 0)
+		{
+			assert(mp->nfree == 0);
+			mp->cur = mp->base;
+		}
+	}
+
+	return count;
+}
+
+static size_t se_msize_by_allocator(void *mptr)
+{
+	assert(g_current_allocator != 0);
+	assert(g_mempool_current != 0L);
+
+	if (mptr == 0L) return 0;
+
+	assert(se_block_of(mptr) != 0L);
+
+	return MEM_HEAD(mptr)->size;
 }
 
 // 一次性分配超大块内存可能导致程序崩溃
@@ -57,51 +202,68 @@ static void* se_alloc_by_allocator(size_t size)
 	assert(g_current_allocator != 0);
 	assert(g_mempool_current != 0L);
 
+	// 小内存优先复用同尺寸类别中已释放的内存段
+	size = size == 0 ? MEM_UNIT_SIZE : MEM_ROUND(size);
+	assert(size <= UINT32_MAX);
+	if (size <= MEM_CLASS_MAX)
+	{
+		memfree_t **head = &g_mempool_current->freelist[MEM_CLASS(size)];
+		if (*head != 0L)
+		{
+			memfree_t *node = *head;
+			*head = node->next;
+
+			memblock_t *owner = se_block_of(node);
+			--owner->nfree;
+			++owner->used;
+			return node;
+		}
+	}
+
 	memblock_t *mp = g_mempool_current->current;
 	assert(mp != 0L);
 	assert(mp->size != 0);
 
+	int reclaimed = 0;
 	while (1)
 	{
-		if (mp->end - mp->cur >= size + sizeof(size_t))
+		if ((size_t)(mp->end - mp->cur + 1) >= size + sizeof(memhead_t))
 		{	// 当前内存块大小足够
-			++mp->used;
-			*(size_t*)mp->cur = size;
-			void *mem = mp->cur + sizeof(size_t);
-			mp->cur += sizeof(size_t) + size;
-			return mem;
+			break;
 		}
 
-		if (mp->next == 0L) break;
-		mp = mp->next;
-	}
-
-	// 内存分配失败，拓展内存池大小
-	size_t next_size = mp->size * 2;
-	while (next_size * MEM_UNIT_SIZE < size + sizeof(size_t))
-	{
-		next_size *= 2;
-	}
-
-	mp->next = (memblock_t*)malloc(sizeof(memblock_t));
-	assert(mp->next != 0L);
+		if (mp->next == 0L && !reclaimed)
+		{	// 拓展内存池之前先重置空闲小内存段所在的空闲内存块，从首块重新查找
+			reclaimed = 1;
+			if (se_pool_reclaim(g_mempool_current, 0) > 0)
+			{
+				mp = g_mempool_current->head;
+				continue;
+			}
+		}
 
-	mp = mp->next;
-	mp->size = next_size;
-	mp->used = 0;
-	mp->next = 0L;
+		if (mp->next == 0L)
+		{	// 内存分配失败，拓展内存池大小
+			size_t next_size = mp->size * 2;
+			while (next_size * MEM_UNIT_SIZE < size + sizeof(memhead_t))
+			{
+				next_size *= 2;
+			}
 
-	mp->cur = (uint8_t*)malloc(mp->size * MEM_UNIT_SIZE);
-	mp->end = mp->cur + mp->size * MEM_UNIT_SIZE - 1;
-	assert(mp->cur != 0L);
+			mp->next = se_block_create(g_mempool_current, next_size);
+			g_mempool_current->current = mp->next;
+		}
+		mp = mp->next;
+	}
 
 	g_mempool_current->current = mp;
 
 	++mp->used;
-	*(size_t*)mp->cur = size;
-	void *mem = mp->cur + sizeof(size_t);
-	mp->cur += sizeof(size_t) + size;
-	return mem;
+	memhead_t *head = (memhead_t*)mp->cur;
+	head->size  = (uint32_t)size;
+	head->block = mp->index;
+	mp->cur += sizeof(memhead_t) + size;
+	return head + 1;
 }
 
 static int se_free_by_allocator(void *mptr)
@@ -109,31 +271,32 @@ static int se_free_by_allocator(void *mptr)
 	assert(g_current_allocator != 0);
 	assert(g_mempool_current != 0L);
 
-	memblock_t *mp = g_mempool_current->head;
-	assert(mp != 0L);
-	assert(mp->size != 0);
-
-	uint8_t *p = (uint8_t*)mptr;
-
-	while (mp != 0L)
+	if (mptr == 0L) return 1;
+
+	memblock_t *mp = se_block_of(mptr);
+	assert(mp->used > 0);
+	--mp->used;
+
+	const size_t size = MEM_HEAD(mptr)->size;
+	if (size <= MEM_CLASS_MAX)
+	{	// 小内存段归入空闲链表，段头保留尺寸；内存块空闲后由se_pool_reclaim移出链表
+		memfree_t *node = (memfree_t*)mptr;
+		memfree_t **head = &g_mempool_current->freelist[MEM_CLASS(size)];
+		node->next = *head;
+		*head = node;
+		++mp->nfree;
+	} else
 	{
-		const size_t bytelen = mp->size * MEM_UNIT_SIZE;
-		if (mp->end - p + 1 <= bytelen - sizeof(size_t))
-		{
-			assert(mp->used > 0);
-			*((size_t*)p - 1) = 0;
-			--mp->used;
-			if (mp->used == 0)
-			{	// 重置该内存块
-				mp->cur = mp->end - bytelen;
-				g_mempool_current->current = mp;
-			}
-			return 0; // 释放成功
-		}
-		mp = mp->next;
+		MEM_HEAD(mptr)->size = 0;
 	}
 
-	return 1;
+	if (mp->used == 0 && mp->nfree == 0)
+	{	// 重置该内存块
+		mp->cur = mp->base;
+		g_mempool_current->current = mp;
+	}
+
+	return 0; // 释放成功
 }
 
 static void* se_realloc_by_allocator(void *mptr, size_t size)
@@ -143,90 +306,132 @@ static void* se_realloc_by_allocator(void *mptr, size_t size)
 	assert(mptr != 0L);
 	assert(size != 0);
 
+	size_t oldsize = MEM_HEAD(mptr)->size;
+	if (size <= oldsize)
+	{	// 原内存段足够，段头尺寸不变，释放时仍归入原尺寸类别
+		return mptr;
+	}
+
 	void *p = se_alloc_by_allocator(size);
 	assert(p != 0L);
 
-	memcpy(p, mptr, size);
-
-	size_t oldsize = *((size_t*)mptr - 1);
+	memcpy(p, mptr, oldsize);
 
 	int state = se_free_by_allocator(mptr);
 	assert(state == 0);
 
-	if (size > oldsize)
+	memset((uint8_t*)p + oldsize, 0, size - oldsize);
+
+	return p;
+}
+
+// 归还当前内存池中除首块外的空闲内存块
+static void se_trim_by_allocator()
+{
+	assert(g_current_allocator != 0);
+	assert(g_mempool_current != 0L);
+
+	se_pool_reclaim(g_mempool_current, 1);
+
+	memblock_t *mp = g_mempool_current->head;
+	assert(mp != 0L);
+
+	while (mp->next != 0L)
 	{
-		memset((uint8_t*)p + oldsize, 0, size - oldsize);
+		memblock_t *next = mp->next;
+		if (next->used == 0)
+		{
+			mp->next = next->next;
+			se_block_destroy(g_mempool_current, next);
+		} else
+		{
+			mp = next;
+		}
 	}
 
-	return p;
+	g_mempool_current->current = g_mempool_current->head;
+}
+
+// 释放内存池的全部内存块
+static void se_pool_release(mempool_t *ppool)
+{
+	memblock_t *pblock = ppool->head;
+	while (pblock != 0L)
+	{
+		memblock_t *tmp = pblock->next;
+		se_block_destroy(ppool, pblock);
+		pblock = tmp;
+	}
+
+	free(ppool->blocks);
+	ppool->blocks = 0L;
+	ppool->head = ppool->current = 0L;
 }
 
 // 释放所有内存池
 void se_alloc_cleanup()
 {
+	se_spin_lock(&g_mempool_lock);
+
 	mempool_t *ppool = g_mempool_root;
-	memblock_t *pblock;
 
 	while (ppool != 0L)
 	{
-		pblock = ppool->head;
-		while (pblock != 0L)
-		{
-			void *p = pblock->end - pblock->size * MEM_UNIT_SIZE + 1;
-			free(p);
-			memblock_t *tmp = pblock->next;
-			free(pblock);
-			pblock = tmp;
-		}
+		se_pool_release(ppool);
 		ppool = ppool->next;
 	}
 
-	g_mempool_current = 0L;
 	g_mempool_root = 0L;
+	se_atomic_inc(&g_mempool_generation);
+
+	se_spin_unlock(&g_mempool_lock);
+
+	g_mempool_current = 0L;
 }
 
 int se_allocator_create(int wanted_id)
 {
+	mempool_t *pnew = (mempool_t*)malloc(sizeof(mempool_t));
+	assert(pnew != 0L);
+
+	memset(pnew, 0, sizeof(mempool_t));
+	pnew->head    = se_block_create(pnew, MEM_INIT_SIZE);
+	pnew->current = pnew->head;
+
+	se_spin_lock(&g_mempool_lock);
+
 	mempool_t dummy, *ppool = &dummy;
 	dummy.next = g_mempool_root;
 	dummy.id = 0;
 
+	int max_id = 0;
 	while (ppool->next != 0)
 	{
+		ppool = ppool->next;
 		if (wanted_id == ppool->id)
-		{
+		{	// 编号已被占用
 			wanted_id = 0;
 		}
-		ppool = ppool->next;
+		if (ppool->id > max_id)
+		{
+			max_id = ppool->id;
+		}
 	}
 
-	int id = wanted_id == 0 ? ppool->id + 1 : wanted_id;
+	int id = wanted_id == 0 ? max_id + 1 : wanted_id;
 	assert(id != 0);
 
-	ppool->next = (mempool_t*)malloc(sizeof(mempool_t));
-	ppool = ppool->next;
-	assert(ppool != 0L);
-
-	memblock_t *pblock = (memblock_t*)malloc(sizeof(memblock_t));
-	assert(pblock != 0L);
-
-	pblock->size = MEM_INIT_SIZE;
-	pblock->used = 0;
-	pblock->cur  = (uint8_t*)malloc(pblock->size * MEM_UNIT_SIZE);
-	pblock->end  = pblock->cur + pblock->size * MEM_UNIT_SIZE - 1;
-	pblock->next = 0L;
-	assert(pblock->cur != 0);
-
-	ppool->id      = id;
-	ppool->next    = 0L;
-	ppool->head    = pblock;
-	ppool->current = ppool->head;
+	pnew->id   = id;
+	pnew->next = 0L;
+	ppool->next = pnew;
 
 	if (g_mempool_root == 0L)
 	{
-		g_mempool_root = ppool;
+		g_mempool_root = pnew;
 	}
 
+	se_spin_unlock(&g_mempool_lock);
+
 	return id;
 }
 
@@ -238,6 +443,8 @@ int se_allocator_destroy(int allocator_id)
 	// 拒绝销毁当前内存分配器
 	if (g_current_allocator == allocator_id) return 1;
 
+	se_spin_lock(&g_mempool_lock);
+
 	mempool_t dummy, *ppool = &dummy;
 	dummy.next = g_mempool_root;
 
@@ -247,32 +454,28 @@ int se_allocator_destroy(int allocator_id)
 		ppool = ppool->next;
 	}
 
-	if (ppool->next->id == allocator_id)
+	if (ppool->next != 0L && ppool->next->id == allocator_id)
 	{
-		memblock_t *pblock = ppool->next->head;
+		mempool_t *target = ppool->next;
 
-		while (pblock != 0L)
+		if (target == g_mempool_root)
 		{
-			void *p = pblock->end - pblock->size * MEM_UNIT_SIZE + 1;
-			free(p);
-			memblock_t *tmp = pblock->next;
-			free(pblock);
-			pblock = tmp;
+			g_mempool_root = target->next;
 		}
 
-		mempool_t *tmp = ppool->next->next;
-		free(ppool->next);
+		ppool->next = target->next;
+		se_atomic_inc(&g_mempool_generation);
 
-		if (ppool->next == g_mempool_root)
-		{
-			g_mempool_root = tmp;
-		}
+		se_spin_unlock(&g_mempool_lock);
 
-		ppool->next = tmp;
+		se_pool_release(target);
+		free(target);
 
 		return 0;
 	}
 
+	se_spin_unlock(&g_mempool_lock);
+
 	return 1;
 }
 
@@ -289,20 +492,46 @@ int se_allocator_set(int allocator_id)
 		return 0;
 	}
 
-	mempool_t *ppool = g_mempool_root;
+	const long generation = se_atomic_load(&g_mempool_generation);
 
-	while (ppool != 0L)
-	{
-		if (ppool->id == allocator_id)
+	int i = 0;
+	for (; i < MEM_CACHE_SIZE; ++i)
+	{	// 命中缓存时无需加锁
+		poolcache_t *cache = &g_pool_cache[i];
+		if (cache->id == allocator_id && cache->generation == generation)
 		{
-			g_mempool_current = ppool;
+			g_mempool_current = cache->pool;
 			g_current_allocator = allocator_id;
 			return 0;
 		}
+	}
+
+	se_spin_lock(&g_mempool_lock);
+
+	mempool_t *ppool = g_mempool_root;
+
+	while (ppool != 0L)
+	{
+		if (ppool->id == allocator_id) break;
 		ppool = ppool->next;
 	}
 
-	return 1;
+	se_spin_unlock(&g_mempool_lock);
+
+	if (ppool == 0L)
+	{
+		return 1;
+	}
+
+	g_pool_cache[g_pool_cache_next++ % MEM_CACHE_SIZE] = (poolcache_t){
+		.id         = allocator_id,
+		.generation = generation,
+		.pool       = ppool,
+	};
+
+	g_mempool_current = ppool;
+	g_current_allocator = allocator_id;
+	return 0;
 }
 
 int se_current_allocator()
@@ -343,4 +572,12 @@ size_t se_msize(void *pb)
 #	error Unsupport OS for se Library
 #endif
 		: se_msize_by_allocator(pb);
+}
+
+void se_alloc_trim()
+{
+	if (g_current_allocator != 0)
+	{
+		se_trim_by_allocator();
+	}
 }
\ No newline at end of file
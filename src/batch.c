@@ -0,0 +1,401 @@
+#ifndef SE_CONTEXT_BUILD
+#error batch.c is only available in context.c
+#endif
+
+#define SE_BATCH_CHUNK 256 // 每个分块的行数
+
+// 预处理后的单元
+typedef struct batchop_s
+{
+	int act;                  // 动作编号
+	int op;                   // 运算符子类型
+	const se_column_t *col;   // 绑定的输入列（为0L时使用num）
+	se_number_t num;          // 字面量或环境中符号的当前值
+	int skip;                 // 短路单元决定结果时跳过的单元数
+} batchop_t;
+
+// 操作数：标量或一个分块的列值
+typedef struct lane_s
+{
+	se_number_t *v; // 列值（标量时仅v[0]有效）
+	int scalar;     // 是否为标量
+} lane_t;
+
+// 检查单元是否均可批量执行，仅接受纯数值表达式，含有短路单元时置lazy
+static int se_batch_check(const seus_t *seus, batchop_t *ops, int *scopes, int *lazy)
+{
+	int depth = 0, nscope = 0;
+
+	int i = 0;
+	for (; i < seus->nus; ++i)
+	{
+		const unit_t *unit = &seus->us[i];
+		batchop_t *op = &ops[i];
+
+		op->act = se_ctx_base_action(unit);
+		op->op   = SE_UNIT_SUBTYPE(*unit);
+		op->col  = 0L;
+		op->skip = unit->idx;
+
+		switch (op->act)
+		{
+			case SE_ACT_JUMP:
+			{
+				*lazy = 1;
+			}
+			continue;
+			case SE_ACT_NUMBER:
+			case SE_ACT_SYMBOL:
+			{
+				++depth;
+			}
+			continue;
+			case SE_ACT_SCOPE:
+			{
+				if (op->op != OP_BRE_S) break;
+				scopes[nscope++] = depth;
+			}
+			continue;
+			case SE_ACT_BRACKET:
+			{	// 空括号产生nil值，无法参与运算
+				if (depth <= scopes[--nscope]) break;
+			}
+			continue;
+			case SE_ACT_SIGN:
+			case SE_ACT_LNOT:
+			case SE_ACT_NOT:
+			continue;
+			case SE_ACT_BASECALC:
+			case SE_ACT_COMPARE:
+			case SE_ACT_BITOP:
+			{
+				--depth;
+			}
+			continue;
+		}
+
+		se_throw(RuntimeError, NonBatchableUnit, i, 0);
+		return 1;
+	}
+
+	return 0;
+}
+
+// 解析字面量，并将符号绑定到输入列或环境中的当前值
+static int se_batch_bind(se_context_t *ctx, const seus_t *seus,
+	const se_column_t *columns, int ncolumns, batchop_t *ops)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	int i = 0;
+	for (; i < seus->nus; ++i)
+	{
+		const unit_t *unit = &seus->us[i];
+		batchop_t *op = &ops[i];
+
+		if (op->act == SE_ACT_NUMBER)
+		{
+			op->num = se_ctx_literal(seus, unit);
+			continue;
+		}
+
+		if (op->act != SE_ACT_SYMBOL)
+		{
+			continue;
+		}
+
+		int c = 0;
+		for (; c < ncolumns; ++c)
+		{
+			const char *symbol = columns[c].symbol;
+			if (strncmp(symbol, unit->tok, unit->len) == 0 && symbol[unit->len] == '\0')
+			{
+				op->col = &columns[c];
+				break;
+			}
+		}
+
+		if (op->col != 0L)
+		{
+			continue;
+		}
+
+		// 未绑定的符号取其在环境中的当前值，编译时已查找的符号直接使用其id
+		uint16_t id = seus->symgen == ctxmem->symgen ? unit->idx : 0;
+		if (id == 0)
+		{
+			s2inode_t *pair = hashmap_find_by_span(&ctxmem->symmap, unit->tok, unit->len);
+			id = pair != 0L ? pair->id : 0;
+		}
+
+		const se_object_t *obj = 0L;
+		if (id != 0 && id <= ctxmem->idstorage_capacity)
+		{
+			obj = &ctxmem->idstorage[id - 1];
+			while (obj->type == EO_OBJ)
+			{
+				obj = (const se_object_t*)obj->data;
+			}
+		}
+
+		if (obj == 0L || obj->type != EO_NUM || obj->is_nil)
+		{
+			se_throw(TypeError, MathOperationAmongNonNumbers,
+				obj == 0L ? EO_NIL : obj->type, 0);
+			return 1;
+		}
+		op->num = *(const se_number_t*)obj->data;
+	}
+
+	return 0;
+}
+
+// 载入输入列的一个分块
+static void se_batch_load(const se_column_t *col, size_t row, size_t n, se_number_t *v)
+{
+	size_t i = 0;
+	if (col->type == EN_FLT)
+	{
+		const double *data = (const double*)col->data + row;
+		for (; i < n; ++i)
+		{
+			v[i].f    = data[i];
+			v[i].type = EN_FLT;
+			v[i].inf  = isinf(data[i]) != 0;
+			v[i].nan  = isnan(data[i]) != 0;
+		}
+	} else
+	{
+		const int32_t *data = (const int32_t*)col->data + row;
+		for (; i < n; ++i)
+		{
+			v[i].i    = data[i];
+			v[i].type = EN_DEC;
+			v[i].inf  = 0;
+			v[i].nan  = 0;
+		}
+	}
+}
+
+// 一元运算，结果写回x
+static int se_batch_unary(const batchop_t *op, lane_t *x, size_t n)
+{
+	const size_t m = x->scalar ? 1 : n;
+
+	size_t i = 0;
+	for (; i < m; ++i)
+	{
+		se_number_t *v = &x->v[i], r;
+		if (se_number_check(v) != 0)
+		{
+			return 1;
+		}
+
+		switch (op->act)
+		{
+			case SE_ACT_SIGN: se_number_sign(op->op, v, &r); break;
+			case SE_ACT_LNOT: se_number_lnot(v, &r); break;
+			case SE_ACT_NOT : if (se_number_not(v, &r) != 0) return 1; break;
+		}
+		*v = r;
+	}
+
+	return 0;
+}
+
+// 二元运算，结果写入r（r可与x的列值重叠）
+static int se_batch_binary(const batchop_t *op, const lane_t *x, const lane_t *y,
+	se_number_t *r, size_t n)
+{
+	// 标量先行复制，避免被写回的结果覆盖
+	const se_number_t xs = x->v[0], ys = y->v[0];
+	const se_number_t *xv = x->scalar ? &xs : x->v;
+	const se_number_t *yv = y->scalar ? &ys : y->v;
+
+	const size_t m  = x->scalar && y->scalar ? 1 : n;
+	const size_t dx = x->scalar ? 0 : 1;
+	const size_t dy = y->scalar ? 0 : 1;
+
+	size_t i = 0;
+	for (; i < m; ++i)
+	{
+		const se_number_t *a = &xv[i * dx];
+		const se_number_t *b = &yv[i * dy];
+		if (se_number_check(a) != 0 || se_number_check(b) != 0)
+		{
+			return 1;
+		}
+
+		se_number_t t;
+		switch (op->act)
+		{
+			case SE_ACT_BASECALC:
+				if (se_number_basecalc(op->op, a, b, &t) != 0) return 1;
+				break;
+			case SE_ACT_COMPARE:
+				se_number_compare(op->op, a, b, &t);
+				break;
+			case SE_ACT_BITOP:
+				if (se_number_bitop(op->op, a, b, &t) != 0) return 1;
+				break;
+		}
+		r[i] = t;
+	}
+
+	return 0;
+}
+
+// 执行一个分块
+static int se_batch_chunk(const batchop_t *ops, int nops, lane_t *lanes,
+	se_number_t *buffers, size_t row, size_t n, se_number_t *out)
+{
+	int sp = -1;
+
+	int i = 0;
+	for (; i < nops; ++i)
+	{
+		const batchop_t *op = &ops[i];
+		switch (op->act)
+		{
+			case SE_ACT_NUMBER:
+			case SE_ACT_SYMBOL:
+			{
+				lane_t *lane = &lanes[++sp];
+				lane->v = buffers + (size_t)sp * SE_BATCH_CHUNK;
+				if (op->col != 0L)
+				{
+					se_batch_load(op->col, row, n, lane->v);
+					lane->scalar = 0;
+				} else
+				{
+					lane->v[0] = op->num;
+					lane->scalar = 1;
+				}
+			}
+			break;
+			case SE_ACT_SIGN:
+			case SE_ACT_LNOT:
+			case SE_ACT_NOT:
+			{
+				if (se_batch_unary(op, &lanes[sp], n) != 0)
+				{
+					return 1;
+				}
+			}
+			break;
+			case SE_ACT_JUMP:
+			{	// 左操作数对整个分块相同时才能短路，否则照常计算右操作数
+				lane_t *x = &lanes[sp];
+				se_number_t r;
+				if ((x->scalar || n == 1)
+					&& se_number_decide(op->op == OP_LOR_JMP ? OP_LOR : OP_LAND, &x->v[0], &r))
+				{
+					x->v[0] = r;
+					i += op->skip;
+				}
+			}
+			break;
+			case SE_ACT_BASECALC:
+			case SE_ACT_COMPARE:
+			case SE_ACT_BITOP:
+			{
+				lane_t *x = &lanes[sp - 1], *y = &lanes[sp];
+				if (se_batch_binary(op, x, y, x->v, n) != 0)
+				{
+					return 1;
+				}
+				x->scalar = x->scalar && y->scalar;
+				--sp;
+			}
+			break;
+		}
+	}
+
+	assert(sp == 0);
+
+	size_t c = 0;
+	for (; c < n; ++c)
+	{
+		out[c] = lanes[0].v[lanes[0].scalar ? 0 : c];
+	}
+
+	return 0;
+}
+
+int se_ctx_batch(se_context_t *ctx, se_program_t *prog,
+	const se_column_t *columns, int ncolumns, size_t nrows, se_number_t *out)
+{
+	assert(ctx != 0L);
+	assert(prog != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	if (prog->seus.us == 0L || prog->seus.nus <= 0 || (nrows > 0 && out == 0L))
+	{
+		return 1;
+	}
+
+	if (ncolumns > 0 && columns == 0L)
+	{
+		return 1;
+	}
+
+	int c = 0;
+	for (; c < ncolumns; ++c)
+	{
+		if (columns[c].symbol == 0L || columns[c].data == 0L
+			|| (columns[c].type != EN_DEC && columns[c].type != EN_FLT))
+		{
+			return 1;
+		}
+	}
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	const seus_t *seus = &prog->seus;
+	const int nef = seus->nef + 1; // 元素帧栈的最大深度
+
+	batchop_t   *ops     = (batchop_t*)se_alloc(sizeof(batchop_t) * seus->nus);
+	int         *scopes  = (int*)se_alloc(sizeof(int) * seus->nus);
+	lane_t      *lanes   = (lane_t*)se_alloc(sizeof(lane_t) * nef);
+	se_number_t *buffers = (se_number_t*)se_alloc(sizeof(se_number_t) * SE_BATCH_CHUNK * nef);
+	assert(ops != 0L && scopes != 0L && lanes != 0L && buffers != 0L);
+
+	int lazy = 0;
+	int state = se_batch_check(seus, ops, scopes, &lazy);
+	if (state == 0)
+	{
+		state = se_batch_bind(ctx, seus, columns, ncolumns, ops);
+	}
+
+	size_t row = 0;
+	while (state == 0 && row < nrows)
+	{
+		const size_t n = nrows - row < SE_BATCH_CHUNK ? nrows - row : SE_BATCH_CHUNK;
+		state = se_batch_chunk(ops, seus->nus, lanes, buffers, row, n, out + row);
+		if (state != 0 && lazy)
+		{	// 短路的行按分块计算时右操作数可能出错，逐行重新执行以得到与逐行执行相同的结果
+			se_exception_t ignored;
+			se_catch_any(&ignored);
+			state = 0;
+
+			size_t k = 0;
+			for (; k < n && state == 0; ++k)
+			{
+				state = se_batch_chunk(ops, seus->nus, lanes, buffers, row + k, 1, out + row + k);
+			}
+		}
+		row += n;
+	}
+
+	se_free(buffers);
+	se_free(lanes);
+	se_free(scopes);
+	se_free(ops);
+
+	se_allocator_set(old_mempool_id);
+
+	return state;
+}
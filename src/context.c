@@ -7,37 +7,55 @@
 #include <assert.h>
 #include <string.h>
 
-#define N_HSAHMAP_SIZE 12
-static const size_t g_hashmap_size[N_HSAHMAP_SIZE] =
-{	// 推荐的哈希表大小
-	53, 97, 193, 389,
-	769, 1543, 3079, 6151,
-	12289, 24593, 49157, 98317,
-};
-
 typedef struct s2inode_s
 {
-	const char *str; // key
+	const char *str; // key（0L为空槽位）
+	uint32_t hash;   // 键的散列值
+	uint16_t len;    // 键长度
 	uint16_t id;     // value
-	struct s2inode_s *next;
 } s2inode_t;
 
-// 挂链哈希表：符号→ID
-// 当哈希表密度过大时将尝试拓展表大小进行重散列
+// 开放寻址哈希表：符号→ID
+// 装载因子超过3/4时容量加倍，旧表在之后的插入中逐步迁移
 typedef struct hashmap_s
 {
-	size_t size_id; // 哈希表大小
-	size_t used; // 已使用表格
+	size_t capacity;      // 槽位数（2的幂）
+	size_t used;          // 键数
 	s2inode_t *table;
+	s2inode_t *old;       // 扩容期间尚未迁移完的旧表
+	size_t old_capacity;  // 旧表槽位数
+	size_t migrated;      // 旧表已迁移的槽位数
 } hashmap_t;
 
-// id分配结构
-typedef struct idlist_s
+// 临时内存类别
+#define TMP_DATA     0 // 数据（数字、函数、数组结构体）
+#define TMP_OBJECT   1 // 引用对象，回收时归还其id
+#define TMP_ELEMENTS 2 // 数组元素列表，回收时归还元素id
+
+// 临时内存记录
+typedef struct tmpnode_s
+{
+	void    *ptr;   // 内存地址
+	uint32_t kind;  // 内存类别
+	uint32_t count; // 元素数量
+} tmpnode_t;
+
+// 标记集合：开放寻址的指针集合（sweep.c），跨se_ctx_sweep调用复用
+typedef struct markset_s
 {
-	int16_t ids[8];
-	int16_t size;
-	struct idlist_s *next;
-} idlist_t;
+	const void **slots;
+	size_t size;
+	size_t capacity; // 2的幂
+} markset_t;
+
+// 源码分块：每次载入的代码自成分块，语句不跨越分块
+typedef struct srcchunk_s
+{
+	struct srcchunk_s *next;
+	char  *text;   // 以'\0'结尾的源码
+	size_t len;    // 源码长度
+	size_t mapped; // 文件映射长度（非0时text指向文件映射）
+} srcchunk_t;
 
 // se_context_t.momery 结构
 typedef struct ctxmemory_s
@@ -46,14 +64,24 @@ typedef struct ctxmemory_s
 	int mempool_id;             // 参考alloc.h
 ///-------- symbol map  --------
 	hashmap_t symmap;           // 符号对id映射表
-	s2inode_t **nilsym_pairs;   // 无效符号列表
+	uint16_t *nilsym_ids;       // 无效符号列表（符号id）
 	size_t nilsym_size;         // 无效符号列表长度
 	size_t nilsym_capacity;     // 无效符号列表容量
+	uint32_t symgen;            // 符号表版本（符号解绑定时递增，程序中缓存的符号id随之失效）
 ///-------- script origin --------
-	char *start_of_statement;   // 语句起始地址
+	srcchunk_t *src_head;       // 正在读取的分块（next_statement指向其中，为0L时该分块已读完）
+	srcchunk_t *src_tail;       // 分块队列末尾
+	srcchunk_t *src_pending;    // 读取回调中尚未凑成完整语句的分块
+	size_t src_capacity;        // src_pending的文本容量
+	se_reader_t reader;         // 读取回调（读完后置0L）
+	void *reader_data;          // 读取回调的用户数据
+	srcchunk_t *src_later;      // 读取回调期间载入的分块（回调读完后依次接在其代码之后）
+	srcchunk_t *src_later_tail; // src_later的末尾
 ///-------- id allocator --------
 	uint16_t prev_available_id; // 递增id值
-	idlist_t *idlist;           // 可用id值
+	uint16_t *freeids;          // 归还的可用id值（栈）
+	size_t freeids_size;        // 可用id数
+	size_t freeids_capacity;    // 栈容量
 ///-------- reference storage --------
 	se_object_t *idstorage;     // 持续对象储存空间（以id为下标访问，存活的唯一标准是对象id与下标一致）
 	size_t idstorage_capacity;  // 持续空间容量
@@ -61,17 +89,49 @@ typedef struct ctxmemory_s
 	se_object_t *blcstorage;    // 过期对象储存空间（beyond life-cycle）
 	size_t blcstorage_size;     // 对象数
 	size_t blcstorage_capacity; // 储存容量
+///-------- temporary storage --------
+	tmpnode_t *tmpstorage;      // 执行期间申请的临时内存（由se_ctx_sweep回收）
+	size_t tmpstorage_size;     // 记录数
+	size_t tmpstorage_capacity; // 记录容量
+	markset_t markset;          // 回收时的标记集合（slots为0L即尚未创建）
+	size_t swept_bytes;         // 上次归还内存块以来回收的字节数
 ///-------- runtime --------
+	seus_t *seus;               // 正在执行的SEUS
 	int ssp;                    // 括号域状态下标指针
-	se_stack_t efs;             // 元素帧栈
-	se_stack_t vfs;             // 移动帧栈
+	se_stack_t efs;             // 元素帧栈（括号域中逗号已接受的值原地保留）
+	char *arena;                // 语句内存区（不脱离语句的临时值，语句结束时整体重置）
+	size_t arena_used;          // 已使用字节数
+	size_t arena_capacity;      // 内存区容量
+	size_t arena_demand;        // 本语句的请求总量（含溢出部分），重置时据此扩容
+	se_number_t resnum;         // 数值结果的储存位置
 	se_object_t result;         // 上一次的执行结果（is_nil=1即结果不存在）
+///-------- executor --------
+	int executor;               // 执行器（SE_EXEC_*）
+	se_object_t *regs;          // 寄存器虚拟机的寄存器
+	int nregs;                  // 寄存器数
+	struct jitchunk_s *jit_code; // 本机代码区（SE_EXEC_JIT，随环境销毁解除映射）
+	size_t jit_mapped;           // 本机代码区的映射字节数
+	int jit_disabled;            // 代码区无法恢复为可执行时置1，此后不再执行本机代码
+///-------- superinstructions --------
+	int fusion;                 // 单元序列的融合方式（SE_FUSE_*）
+	uint32_t fuseset;           // 启用的超级指令（fuse.c）
+	uint32_t fusegen;           // 融合集版本（融合集变化时递增，SEUS据此重新融合）
+	uint32_t *fuse_pairs;       // SE_FUSE_PROFILE：相邻单元的动作对计数（选取融合集后释放）
+	uint64_t fuse_npairs;       // 已累计的单元对数
 } ctxmemory_t;
 
 #define SE_CONTEXT_BUILD
 #include "ctxinternal.c"
 #include "hashmap.c"
 #include "action.c"
+#include "fold.c"
+#include "fuse.c"
+#include "regvm.c"
+#include "jit.c"
+#include "sweep.c"
+#include "batch.c"
+#include "source.c"
+#include "script.c"
 
 int se_ctx_create(se_context_t *ctx)
 {
@@ -91,24 +151,24 @@ int se_ctx_create(se_context_t *ctx)
 	memset(ctxmem, 0, sizeof(ctxmemory_t));
 
 	ctxmem->mempool_id = id;
-	ctxmem->symmap.size_id = 0;
-	ctxmem->symmap.used = 0;
-
-	const int size = g_hashmap_size[ctxmem->symmap.size_id];
-	s2inode_t *table = (s2inode_t*)se_alloc(size * sizeof(s2inode_t));
-	assert(table != 0L);
+	int state = hashmap_init(&ctxmem->symmap);
+	assert(state == 0);
 
-	memset(table, 0, size * sizeof(s2inode_t));
-	ctxmem->symmap.table = table;
 	ctxmem->nilsym_capacity = 32;
-	ctxmem->nilsym_pairs = (s2inode_t**)se_alloc(
-		sizeof(s2inode_t*) * ctxmem->nilsym_capacity);
-	assert(ctxmem->nilsym_pairs != 0L);
+	ctxmem->nilsym_ids = (uint16_t*)se_alloc(
+		sizeof(uint16_t) * ctxmem->nilsym_capacity);
+	assert(ctxmem->nilsym_ids != 0L);
+	ctxmem->symgen = 1; // SEUS的版本0表示尚未查找符号
 
-	ctxmem->start_of_statement = 0L;
+	ctxmem->fusion  = SE_FUSE_ALL;
+	ctxmem->fuseset = SE_FUSE_FULLSET;
+	ctxmem->fusegen = 1; // SEUS的版本0表示尚未融合
 
 	ctxmem->prev_available_id = 0;
-	ctxmem->idlist = 0L;
+	ctxmem->freeids_capacity = 32;
+	ctxmem->freeids = (uint16_t*)se_alloc(
+		sizeof(uint16_t) * ctxmem->freeids_capacity);
+	assert(ctxmem->freeids != 0L);
 
 	ctxmem->idstorage_capacity = 32;
 	ctxmem->idstorage = (se_object_t*)se_alloc(
@@ -122,6 +182,11 @@ int se_ctx_create(se_context_t *ctx)
 		sizeof(se_object_t) * ctxmem->blcstorage_capacity);
 	assert(ctxmem->blcstorage != 0L);
 
+	ctxmem->tmpstorage_capacity = 32;
+	ctxmem->tmpstorage = (tmpnode_t*)se_alloc(
+		sizeof(tmpnode_t) * ctxmem->tmpstorage_capacity);
+	assert(ctxmem->tmpstorage != 0L);
+
 	ctx->symbols = &ctxmem->symmap;
 
 	ctx->memory = ctxmem;
@@ -149,6 +214,18 @@ int se_ctx_destroy(se_context_t *ctx)
 		se_allocator_restore();
 	}
 
+	// 分块内存随内存池一并归还，文件映射需单独解除
+	srcchunk_t *chunk = ctxmem->src_head;
+	for (; chunk != 0L; chunk = chunk->next)
+	{
+		se_ctx_source_unmap(chunk);
+	}
+	for (chunk = ctxmem->src_later; chunk != 0L; chunk = chunk->next)
+	{
+		se_ctx_source_unmap(chunk);
+	}
+	se_jit_release(ctxmem);
+
 	int state = se_allocator_destroy(ctxmem->mempool_id);
 	assert(state == 0);
 
@@ -168,39 +245,79 @@ int se_ctx_load(se_context_t *ctx, const char *script)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	int offset = 0;
-	if (ctx->next_statement != 0L)
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	const size_t len = strlen(script);
+	srcchunk_t *chunk = se_ctx_source_chunk(len);
+	assert(chunk != 0L);
+	memcpy(chunk->text, script, len + 1);
+	chunk->len = len;
+
+	se_ctx_source_append(ctx, chunk);
+
+	se_allocator_set(old_mempool_id);
+
+	return 0;
+}
+
+int se_ctx_load_reader(se_context_t *ctx, se_reader_t reader, void *data)
+{
+	assert(ctx != 0L);
+	assert(ctx->memory != 0L);
+
+	if (reader == 0L)
 	{
-		offset = ctxmem->start_of_statement - ctx->next_statement;
+		return 1;
 	}
 
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
 	int old_mempool_id = se_current_allocator();
 	se_allocator_set(ctxmem->mempool_id);
 
-	const size_t len2 = strlen(script);
-	if (ctx->next_statement == 0L)
+	// 上一个读取回调遗留的代码视为完整语句
+	se_ctx_source_flush(ctx);
+
+	ctxmem->reader = reader;
+	ctxmem->reader_data = data;
+
+	se_allocator_set(old_mempool_id);
+
+	return 0;
+}
+
+int se_ctx_load_file(se_context_t *ctx, const char *path)
+{
+	assert(ctx != 0L);
+	assert(ctx->memory != 0L);
+
+	if (path == 0L)
 	{
-		if (ctxmem->start_of_statement != 0L)
-		{
-			se_free(ctxmem->start_of_statement);
-		}
-		ctxmem->start_of_statement = (char*)se_alloc(len2 + 1);
-		assert(ctxmem->start_of_statement != 0L);
-		strcpy(ctxmem->start_of_statement, script);
-		ctx->next_statement = ctxmem->start_of_statement;
-	} else
+		return 1;
+	}
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	srcchunk_t *chunk = se_ctx_source_map(path);
+	if (chunk == 0L)
+	{	// 无法映射时（如管道文件）读入分块
+		chunk = se_ctx_source_read(path);
+	}
+
+	if (chunk != 0L)
 	{
-		const size_t len1 = strlen(ctxmem->start_of_statement);
-		ctxmem->start_of_statement = (char*)se_realloc(ctxmem->start_of_statement, len1 + len2 + 2);
-		ctx->next_statement = ctxmem->start_of_statement + offset;
-		char *p = ctxmem->start_of_statement;
-		p[len1] = ';';
-		memcpy(p + len1 + 1, script, len2 + 1);
+		se_ctx_source_append(ctx, chunk);
 	}
 
 	se_allocator_set(old_mempool_id);
 
-	return 0;
+	return chunk == 0L;
 }
 
 int se_ctx_complete(se_context_t *ctx)
@@ -210,6 +327,11 @@ int se_ctx_complete(se_context_t *ctx)
 
 	if (ctx->state == ECTX_WAIT) return 1;
 
+	if (ctx->next_statement == 0L && ctx->state != ECTX_UNBUILD)
+	{	// 当前分块已读完，切换到下一个分块
+		ctx->next_statement = se_ctx_source_next(ctx);
+	}
+
 	if (ctx->next_statement == 0L) return 0;
 
 	return 1;
@@ -231,8 +353,21 @@ int se_ctx_forward(se_context_t *ctx)
 	int old_mempool_id = se_current_allocator();
 	se_allocator_set(ctxmem->mempool_id);
 
-	while (ctx->next_statement != 0L)
+	for (;;)
 	{
+		if (ctx->raw_tokens != 0L)
+		{
+			se_free(ctx->raw_tokens);
+			ctx->raw_tokens = 0L;
+			ctx->ntokens = 0;
+		}
+
+		if (ctx->next_statement == 0L)
+		{
+			ctx->next_statement = se_ctx_source_next(ctx);
+			if (ctx->next_statement == 0L) break;
+		}
+
 		ctx->next_statement = str2tokens(
 			ctx->next_statement, &ctx->raw_tokens, (int*)&ctx->ntokens);
 
@@ -269,36 +404,85 @@ int se_ctx_parse(se_context_t *ctx)
 	int old_mempool_id = se_current_allocator();
 	se_allocator_set(ctxmem->mempool_id);
 
-	se_free(&ctx->seus);
+	// ctx->seus的缓冲区在语句之间复用
+	if (toks2seus(ctx->raw_tokens, ctx->ntokens, &ctx->seus) != 0)
+	{
+		ctx->state = ECTX_ERROR;
+		se_allocator_set(old_mempool_id);
+		return 0;
+	}
 
-	unit_t *rpn = 0L;
-	int     nrp = 0;
+	se_ctx_link(&ctx->seus);
+	se_ctx_fold(&ctx->seus);
 
-	rpn = toks2rpn(ctx->raw_tokens, ctx->ntokens, &nrp);
+	ctx->state = ECTX_WAIT;
+	se_allocator_set(old_mempool_id);
+	return 0;
+}
 
-	if (!se_caught())
+int se_ctx_compile(se_context_t *ctx, const char *script, se_program_t *prog)
+{	// 编译首个语句，程序持有源码副本与SEUS
+	assert(ctx != 0L);
+	assert(prog != 0L);
+
+	memset(prog, 0, sizeof(se_program_t));
+
+	if (script == 0L)
 	{
-		ctx->state = ECTX_ERROR;
+		return 1;
+	}
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	size_t len = 0;
+	while (script[len] != ';' && script[len] != '\0')
+	{
+		++len;
+	}
+
+	char *source = (char*)se_alloc(len + 1);
+	assert(source != 0L);
+	memcpy(source, script, len);
+	source[len] = '\0';
+
+	token_t *tokens = 0L;
+	int ntokens = 0;
+	str2tokens(source, &tokens, &ntokens);
+
+	if (!se_caught() || ntokens == 0)
+	{
+		se_free(source);
 		se_allocator_set(old_mempool_id);
-		return 0;
+		return 1;
 	}
 
-	ctx->seus = rpn2seus(rpn, nrp);
+	seus_t seus = { 0 };
+	int state = toks2seus(tokens, ntokens, &seus);
+	se_free(tokens);
 
-	if (!se_caught())
+	if (state != 0)
 	{
-		ctx->state = ECTX_ERROR;
+		free_seus(&seus);
+		se_free(source);
 		se_allocator_set(old_mempool_id);
-		return 0;
+		return 1;
 	}
 
-	ctx->state = ECTX_WAIT;
+	se_ctx_link(&seus);
+	se_ctx_fold(&seus);
+	se_ctx_intern(ctxmem, &seus);
+
+	prog->seus   = seus;
+	prog->source = source;
+
 	se_allocator_set(old_mempool_id);
 	return 0;
 }
 
-int se_ctx_compile(se_context_t *ctx); // 编译全部代码
-
 int se_ctx_onestep(se_context_t *ctx, unit_t *unit)
 {	// 单步执行，映射动作
 	assert(ctx != 0L);
@@ -312,71 +496,106 @@ int se_ctx_onestep(se_context_t *ctx, unit_t *unit)
 	}
 
 	assert(unit != 0L);
+	assert(ctxmem->seus != 0L);
 	assert(ctxmem->efs.stack != 0L);
-	assert(ctxmem->vfs.stack != 0L);
 
 	int old_mempool_id = se_current_allocator();
 	se_allocator_set(ctxmem->mempool_id);
 
-	int type = SE_UNIT_TYPE(*unit);
-	int subtype = SE_UNIT_SUBTYPE(*unit);
-
-	if (type == T_SYMBOL)
-		se_ctx_action_assign_symbol(ctx, unit);
-	else if (type == T_NUMBER)
-		se_ctx_action_assign_number(ctx, unit);
-	else switch (subtype)
-	{
-		case OP_BRE_S:
-		case OP_ARG_S:
-		case OP_IDX_S:
-		case OP_ARR_S:  ctx->seus.ss[++ctxmem->ssp] = (scopestate_t){ (int)ctxmem->efs.size, 0 }; break;
-		case OP_BRE:    se_ctx_action_bracketval(ctx, unit);   break;
-		case OP_ARG:    se_ctx_action_fncall(ctx, unit);       break;
-		case OP_IDX:    se_ctx_action_index(ctx, unit);        break;
-		case OP_ARR:    se_ctx_action_makearray(ctx, unit);    break;
-		case OP_ASS:    se_ctx_action_assign (ctx, unit);      break;
-		case OP_CME:    se_ctx_action_mov2vfs(ctx, unit);      break;
-		case OP_EPA:    se_ctx_action_exparray(ctx, unit);     break;
-		case OP_PL:
-		case OP_NL:     se_ctx_action_sign(ctx, unit);         break;
-		case OP_ADD:
-		case OP_SUB:
-		case OP_MOD:
-		case OP_MUL:
-		case OP_DIV:    se_ctx_action_basecalc(ctx, unit);     break;
-		case OP_GTR:
-		case OP_GEQ:
-		case OP_LSS:
-		case OP_LEQ:
-		case OP_EQU:
-		case OP_NEQ:
-		case OP_LAND:
-		case OP_LOR:    se_ctx_action_compare(ctx, unit);      break;
-		case OP_LNOT:   se_ctx_action_logical_not(ctx, unit);  break;
-		case OP_NOT:    se_ctx_action_bitwise_not(ctx, unit);  break;
-		case OP_LSH:
-		case OP_RSH:
-		case OP_AND:
-		case OP_XOR:
-		case OP_OR:     se_ctx_action_binary_bitop(ctx, unit); break;
-		case OP_ADD_ASS:
-		case OP_SUB_ASS:
-		case OP_MOD_ASS:
-		case OP_MUL_ASS:
-		case OP_DIV_ASS:
-		case OP_LSH_ASS:
-		case OP_RSH_ASS:
-		case OP_AND_ASS:
-		case OP_XOR_ASS:
-		case OP_OR_ASS: se_ctx_action_calc_and_ass(ctx, unit); break;
+	if (unit->act == SE_ACT_NOP)
+	{
+		unit->act = se_ctx_resolve_action(unit);
 	}
 
+	// 单步执行时短路单元不跳过右操作数，左操作数已替换为结果，运算符的结果不变
+	// 超级指令的首单元按其自身的动作执行
+	g_actions[se_ctx_base_action(unit)](ctx, unit);
+
 	se_allocator_set(old_mempool_id);
 
 	return !se_caught();
 }
 
+// 在当前内存分配器下执行SEUS，成功时结果存入ctxmem->result
+static int se_ctx_exec(se_context_t *ctx, seus_t *seus)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (ctxmem->efs.stack == 0L)
+	{
+		ctxmem->efs = se_stack_create(seus->nef + seus->nvf);
+	}
+
+	ctxmem->efs.size = 0;
+
+	if (ctxmem->arena == 0L)
+	{	// 初始容量按每个单元一个临时数值估算
+		ctxmem->arena_demand = se_ctx_arena_align(sizeof(se_number_t)) * seus->nus;
+		se_ctx_arena_reset(ctxmem);
+	}
+
+	if (seus->symgen != ctxmem->symgen)
+	{
+		se_ctx_intern(ctxmem, seus);
+	}
+
+	ctxmem->seus = seus;
+
+	regcode_t *code = ctxmem->executor != SE_EXEC_STACK
+		? se_rvm_prepare(seus) : 0L;
+
+	se_object_t result;
+	if (code != 0L)
+	{
+		if (ctxmem->executor != SE_EXEC_JIT || se_jit_exec(ctx, seus, code, &result) != 0)
+		{	// 未编译为本机代码或需要解释执行
+			se_rvm_exec(ctx, code, &result);
+		}
+	} else
+	{
+		if (ctxmem->fuse_pairs != 0L)
+		{
+			se_fuse_profile(ctxmem, seus);
+		}
+		if (seus->fusegen != ctxmem->fusegen)
+		{
+			se_ctx_fuse(ctxmem, seus);
+		}
+
+		ctxmem->ssp = -1;
+		seus->ss[++ctxmem->ssp] = (scopestate_t){ 0, 0 };
+
+		unit_t *unit = seus->us, *end = seus->us + seus->nus;
+		for (; unit != end; ++unit)
+		{	// 动作出错时返回1，仅在此时检查异常；短路单元与超级指令跳过其后的单元
+			const int state = g_actions[unit->act](ctx, unit);
+			if (state != 0)
+			{
+				if (state < SE_ACT_SKIPPED) break;
+				unit += state - SE_ACT_SKIPPED;
+			}
+		}
+	}
+
+	if (!se_caught())
+	{
+		ctxmem->seus = 0L;
+		se_ctx_arena_reset(ctxmem);
+		return 1;
+	}
+
+	ctxmem->result = code != 0L ? result : se_stack_pop(&ctxmem->efs);
+	if (ctxmem->result.type == EO_NUM && se_ctx_in_arena(ctxmem, ctxmem->result.data))
+	{	// 语句内存区即将重置
+		ctxmem->resnum = *(se_number_t*)ctxmem->result.data;
+		ctxmem->result.data = &ctxmem->resnum;
+	}
+	ctxmem->seus = 0L;
+	se_ctx_arena_reset(ctxmem);
+
+	return 0;
+}
+
 int se_ctx_execute(se_context_t *ctx)
 {
 	assert(ctx != 0L);
@@ -392,28 +611,116 @@ int se_ctx_execute(se_context_t *ctx)
 	int old_mempool_id = se_current_allocator();
 	se_allocator_set(ctxmem->mempool_id);
 
-	se_stack_free(&ctxmem->efs);
-	se_stack_free(&ctxmem->vfs);
+	int state = se_ctx_exec(ctx, &ctx->seus);
+	ctx->state = state == 0 ? ECTX_DONE : ECTX_ERROR;
 
-	ctxmem->efs = se_stack_create(ctx->seus.nef);
-	ctxmem->vfs = se_stack_create(ctx->seus.nvf);
+	se_allocator_set(old_mempool_id);
 
-	ctxmem->ssp = -1;
-	ctx->seus.ss[++ctxmem->ssp] = (scopestate_t){ 0, 0 };
+	return state;
+}
 
-	int i = 0;
-	for (; i < ctx->seus.nus; ++i)
+int se_ctx_run(se_context_t *ctx, se_program_t *prog)
+{
+	assert(ctx != 0L);
+	assert(prog != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	if (prog->seus.us == 0L || prog->seus.ss == 0L)
 	{
-		if (se_ctx_onestep(ctx, ctx->seus.us + i) != 0)
+		return 1;
+	}
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	int state = se_ctx_exec(ctx, &prog->seus);
+
+	se_allocator_set(old_mempool_id);
+
+	return state;
+}
+
+int se_ctx_set_executor(se_context_t *ctx, int executor)
+{
+	assert(ctx != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	if (executor != SE_EXEC_STACK && executor != SE_EXEC_REGISTER && executor != SE_EXEC_JIT)
+	{
+		return 1;
+	}
+
+	ctxmem->executor = executor;
+
+	return 0;
+}
+
+int se_ctx_set_fusion(se_context_t *ctx, int mode)
+{
+	assert(ctx != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	if (mode != SE_FUSE_NONE && mode != SE_FUSE_ALL && mode != SE_FUSE_PROFILE)
+	{
+		return 1;
+	}
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	if (ctxmem->fuse_pairs != 0L)
+	{
+		se_free(ctxmem->fuse_pairs);
+		ctxmem->fuse_pairs = 0L;
+	}
+	ctxmem->fuse_npairs = 0;
+
+	if (mode == SE_FUSE_PROFILE)
+	{	// 统计期间逐单元执行
+		const size_t size = SE_ACT_FUSED * SE_ACT_FUSED * sizeof(uint32_t);
+		ctxmem->fuse_pairs = (uint32_t*)se_alloc(size);
+		if (ctxmem->fuse_pairs == 0L)
 		{
 			se_allocator_set(old_mempool_id);
-			ctx->state = ECTX_ERROR;
+			se_throw(RuntimeError, BadAlloc, size, 0);
 			return 1;
 		}
+		memset(ctxmem->fuse_pairs, 0, size);
 	}
 
-	ctxmem->result = se_stack_pop(&ctxmem->efs);
-	ctx->state = ECTX_DONE;
+	ctxmem->fusion  = mode;
+	ctxmem->fuseset = mode == SE_FUSE_ALL ? SE_FUSE_FULLSET : 0;
+	++ctxmem->fusegen;
+
+	se_allocator_set(old_mempool_id);
+
+	return 0;
+}
+
+int se_ctx_discard(se_context_t *ctx, se_program_t *prog)
+{
+	assert(ctx != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	if (prog == 0L) return 1;
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	free_seus(&prog->seus);
+	if (prog->source != 0L)
+	{
+		se_free(prog->source);
+	}
+	prog->source = 0L;
 
 	se_allocator_set(old_mempool_id);
 
@@ -444,7 +751,7 @@ int se_ctx_savetmp(se_context_t *ctx, void *data, int type, void **pp)
 		default: assert(0);
 	}
 
-	void *p = se_ctx_request(ctx, size);
+	void *p = se_ctx_reqtmp(ctx, size, TMP_DATA, 1);
 	if (p == 0L)
 	{
 		se_throw(RuntimeError, BadAlloc, size, 0);
@@ -493,7 +800,11 @@ int se_ctx_bind(se_context_t *ctx, void *data, int type, const char *symbol)
 			se_throw(RuntimeError, NoAvailableID, ctxmem->prev_available_id, 0);
 			return 1;
 		}
+		// 符号表在环境的内存池中扩容
+		int old_mempool_id = se_current_allocator();
+		se_allocator_set(ctxmem->mempool_id);
 		hashmap_insert(&ctxmem->symmap, _symbol, symid);
+		se_allocator_set(old_mempool_id);
 	} else
 	{
 		symid = pair->id;
@@ -505,20 +816,9 @@ int se_ctx_bind(se_context_t *ctx, void *data, int type, const char *symbol)
 		return 1;
 	}
 
-	if (symid > ctxmem->idstorage_capacity)
+	if (se_ctx_reserve_idstorage(ctx, symid) != 0)
 	{
-		const size_t size = sizeof(se_object_t) * ctxmem->idstorage_capacity;
-		se_object_t *idstorage = (se_object_t*)se_ctx_request(ctx, size * 2);
-		if (idstorage == 0L)
-		{
-			se_throw(RuntimeError, BadAlloc, size * 2, 0);
-			return 1;
-		}
-		ctxmem->idstorage_capacity *= 2;
-		memcpy(idstorage, ctxmem->idstorage, size);
-		memset(idstorage + ctxmem->idstorage_capacity, 0, size);
-		se_ctx_release(ctx, ctxmem->idstorage);
-		ctxmem->idstorage = idstorage;
+		return 1;
 	}
 
 	void *obj_data;
@@ -564,14 +864,18 @@ int se_ctx_unbind(se_context_t *ctx, const char *symbol)
 		return 1;
 	}
 
-	ctxmem->idstorage[pair->id].is_nil = 1;
+	ctxmem->idstorage[pair->id - 1].is_nil = 1;
 
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
 	hashmap_remove(&ctxmem->symmap, symbol);
+	se_allocator_set(old_mempool_id);
+	++ctxmem->symgen;
 
 	return 0;
 }
 
-// 处理blc的废弃变量（待完成）
+// 回收过期对象与不可达的临时内存，并归还空闲的内存块
 int se_ctx_sweep(se_context_t *ctx)
 {
 	assert(ctx != 0L);
@@ -579,6 +883,31 @@ int se_ctx_sweep(se_context_t *ctx)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	// blc中的对象已脱离生命周期，其内存由临时内存记录统一回收
+	ctxmem->blcstorage_size = 0;
+
+	size_t bytes = 0;
+	int count = se_ctx_collect(ctx, &bytes);
+	if (count < 0)
+	{
+		se_allocator_set(old_mempool_id);
+		se_throw(RuntimeError, BadAlloc, 0, 0);
+		return 1;
+	}
+
+	// 回收的内存累计足够时才归还空闲内存块，逐语句回收时不必每次整理内存池
+	ctxmem->swept_bytes += bytes;
+	if (ctxmem->swept_bytes >= SE_SWEEP_TRIM)
+	{
+		ctxmem->swept_bytes = 0;
+		se_alloc_trim();
+	}
+
+	se_allocator_set(old_mempool_id);
+
 	return 0;
 }
 
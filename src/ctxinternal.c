@@ -11,15 +11,9 @@ static int se_ctx_allocid(se_context_t *ctx, uint16_t *id)
 	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
 	assert(ctxmem != 0L);
 
-	if (ctxmem->idlist != 0L)
+	if (ctxmem->freeids_size > 0)
 	{
-		*id = ctxmem->idlist->ids[--ctxmem->idlist->size];
-		idlist_t *next = ctxmem->idlist->next;
-		if (ctxmem->idlist->size == 0 && next != 0L)
-		{
-			se_ctx_release(ctx, ctxmem->idlist);
-			ctxmem->idlist = next;
-		}
+		*id = ctxmem->freeids[--ctxmem->freeids_size];
 		return 0;
 	} else if (ctxmem->prev_available_id < 0xffff)
 	{
@@ -31,6 +25,68 @@ static int se_ctx_allocid(se_context_t *ctx, uint16_t *id)
 	}
 }
 
+// 扩容持续空间直至可容纳id（id可能超过当前容量的两倍）
+static int se_ctx_reserve_idstorage(se_context_t *ctx, uint16_t id)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (id <= ctxmem->idstorage_capacity)
+	{
+		return 0;
+	}
+
+	size_t capacity = ctxmem->idstorage_capacity;
+	while (capacity < id)
+	{
+		capacity <<= 1;
+	}
+
+	const size_t size = sizeof(se_object_t) * ctxmem->idstorage_capacity;
+	se_object_t *idstorage = (se_object_t*)se_ctx_request(ctx, sizeof(se_object_t) * capacity);
+	if (idstorage == 0L)
+	{
+		se_throw(RuntimeError, BadAlloc, sizeof(se_object_t) * capacity, 0);
+		return 1;
+	}
+	memcpy(idstorage, ctxmem->idstorage, size);
+	memset(idstorage + ctxmem->idstorage_capacity, 0,
+		sizeof(se_object_t) * (capacity - ctxmem->idstorage_capacity));
+	ctxmem->idstorage_capacity = capacity;
+	se_ctx_release(ctx, ctxmem->idstorage);
+	ctxmem->idstorage = idstorage;
+
+	return 0;
+}
+
+// 扩容可用id栈直至可再容纳count个id
+static int se_ctx_reserve_freeids(se_context_t *ctx, size_t count)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (ctxmem->freeids_size + count <= ctxmem->freeids_capacity)
+	{
+		return 0;
+	}
+
+	size_t capacity = ctxmem->freeids_capacity;
+	while (capacity < ctxmem->freeids_size + count)
+	{
+		capacity <<= 1;
+	}
+
+	uint16_t *ids = (uint16_t*)se_ctx_request(ctx, sizeof(uint16_t) * capacity);
+	if (ids == 0L)
+	{
+		return 1;
+	}
+	memcpy(ids, ctxmem->freeids, sizeof(uint16_t) * ctxmem->freeids_size);
+	ctxmem->freeids_capacity = capacity;
+	se_ctx_release(ctx, ctxmem->freeids);
+	ctxmem->freeids = ids;
+
+	return 0;
+}
+
 // 归还id
 static int se_ctx_releaseid(se_context_t *ctx, uint16_t id)
 {
@@ -48,15 +104,12 @@ static int se_ctx_releaseid(se_context_t *ctx, uint16_t id)
 	{
 		--ctxmem->prev_available_id;
 		return 0;
-	} else if (ctxmem->idlist->size == 8)
-	{	// 当前空闲id表无多余位置
-		idlist_t *root = se_ctx_request(ctx, sizeof(idlist_t));
-		root->next = ctxmem->idlist;
-		root->size = 0;
-		ctxmem->idlist = root;
+	} else if (se_ctx_reserve_freeids(ctx, 1) != 0)
+	{	// 可用id栈无法扩容
+		return 1;
 	}
 
-	ctxmem->idlist->ids[ctxmem->idlist->size++] = id;
+	ctxmem->freeids[ctxmem->freeids_size++] = id;
 
 	return 0;
 }
@@ -88,4 +141,98 @@ static int se_ctx_mov2blc(se_context_t *ctx, se_object_t *obj)
 	ctxmem->blcstorage[ctxmem->blcstorage_size++] = *obj;
 
 	return 0;
-}
\ No newline at end of file
+}
+
+// 申请语句执行期间的临时内存，并交由se_ctx_sweep回收
+static void* se_ctx_reqtmp(se_context_t *ctx, size_t size, int kind, size_t count)
+{
+	assert(ctx != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	if (ctxmem->tmpstorage_size == ctxmem->tmpstorage_capacity)
+	{
+		const size_t size = sizeof(tmpnode_t) * ctxmem->tmpstorage_capacity;
+		void *p = se_ctx_request(ctx, size * 2);
+		if (p == 0L)
+		{
+			return 0L;
+		}
+		memcpy(p, ctxmem->tmpstorage, size);
+		ctxmem->tmpstorage_capacity *= 2;
+		se_ctx_release(ctx, ctxmem->tmpstorage);
+		ctxmem->tmpstorage = (tmpnode_t*)p;
+	}
+
+	void *ptr = se_ctx_request(ctx, size);
+	if (ptr == 0L)
+	{
+		return 0L;
+	}
+
+	ctxmem->tmpstorage[ctxmem->tmpstorage_size++] = (tmpnode_t){
+		.ptr   = ptr,
+		.kind  = kind,
+		.count = count,
+	};
+
+	return ptr;
+}
+
+// 语句内存区的对齐粒度
+static inline size_t se_ctx_arena_align(size_t size)
+{
+	const size_t align = sizeof(void*) * 2;
+	return (size + align - 1) & ~(align - 1);
+}
+
+// 从语句内存区申请内存，空间不足时返回0L，由调用者改用内存池
+static inline void* se_ctx_arena_alloc(ctxmemory_t *ctxmem, size_t size)
+{
+	size = se_ctx_arena_align(size);
+	ctxmem->arena_demand += size;
+
+	if (ctxmem->arena_used + size > ctxmem->arena_capacity)
+	{
+		return 0L;
+	}
+
+	void *p = ctxmem->arena + ctxmem->arena_used;
+	ctxmem->arena_used += size;
+	return p;
+}
+
+static inline int se_ctx_in_arena(const ctxmemory_t *ctxmem, const void *p)
+{
+	return ctxmem->arena != 0L
+		&& (const char*)p >= ctxmem->arena
+		&& (const char*)p <  ctxmem->arena + ctxmem->arena_capacity;
+}
+
+// 语句结束时整体重置；本语句发生溢出时按需求量扩容，此时内存区中已无存活值
+static void se_ctx_arena_reset(ctxmemory_t *ctxmem)
+{
+	if (ctxmem->arena_demand > ctxmem->arena_capacity)
+	{
+		size_t capacity = ctxmem->arena_capacity > 0 ? ctxmem->arena_capacity : 256;
+		while (capacity < ctxmem->arena_demand)
+		{
+			capacity *= 2;
+		}
+
+		if (ctxmem->arena != 0L)
+		{
+			se_free(ctxmem->arena);
+		}
+		ctxmem->arena = (char*)se_alloc(capacity);
+		assert(ctxmem->arena != 0L);
+		ctxmem->arena_capacity = capacity;
+	}
+
+	ctxmem->arena_used   = 0;
+	ctxmem->arena_demand = 0;
+
+	// 过期对象记录可能引用内存区中的值，同样不跨语句保留
+	ctxmem->blcstorage_size = 0;
+}
@@ -0,0 +1,300 @@
+#ifndef SE_CONTEXT_BUILD
+#error fold.c is only available in context.c
+#endif
+
+// 折叠时的括号域
+typedef struct foldscope_s
+{
+	int pos;   // 起始单元在输出中的位置
+	int depth; // 进入括号域时的操作数深度
+	int dirty; // 域内有逗号或数组解构，括号不可移除
+} foldscope_t;
+
+// 折叠时尚未到达目标的短路单元
+typedef struct foldjump_s
+{
+	int pos;    // 短路单元在输出中的位置
+	int target; // 目标单元（运算符）在输入中的位置
+} foldjump_t;
+
+// 折叠一元运算，操作数为常量池中的数字单元
+// 执行期会抛出异常的运算不折叠，留待执行时报告
+static int se_ctx_fold_unary(seus_t *seus, unit_t *x, const unit_t *op)
+{
+	se_number_t *v = &seus->cs[x->idx], r;
+
+	if (v->nan || v->inf)
+	{
+		return 0;
+	}
+
+	switch (op->act)
+	{
+		case SE_ACT_SIGN: se_number_sign(SE_UNIT_SUBTYPE(*op), v, &r); break;
+		case SE_ACT_LNOT: se_number_lnot(v, &r); break;
+		case SE_ACT_NOT:
+		{
+			if (v->type == EN_FLT) return 0;
+			se_number_not(v, &r);
+		}
+		break;
+		default: return 0;
+	}
+
+	*v = r;
+	x->type = (uint16_t)(T_NUMBER << 8 | r.type);
+
+	return 1;
+}
+
+// 折叠二元运算，结果写入左操作数的常量池位置
+static int se_ctx_fold_binary(seus_t *seus, unit_t *x, const unit_t *y, const unit_t *op)
+{
+	se_number_t *a = &seus->cs[x->idx], *b = &seus->cs[y->idx], r;
+
+	if (a->nan || a->inf || b->nan || b->inf)
+	{
+		return 0;
+	}
+
+	const int subtype = SE_UNIT_SUBTYPE(*op);
+	const int useflt = a->type == EN_FLT || b->type == EN_FLT;
+
+	switch (op->act)
+	{
+		case SE_ACT_BASECALC:
+		{
+			if (subtype == OP_MOD && useflt) return 0;
+			if ((subtype == OP_DIV || subtype == OP_MOD) && !useflt
+				&& (b->i == 0 || (a->i == INT32_MIN && b->i == -1)))
+			{
+				return 0;
+			}
+			se_number_basecalc(subtype, a, b, &r);
+		}
+		break;
+		case SE_ACT_COMPARE: se_number_compare(subtype, a, b, &r); break;
+		case SE_ACT_BITOP:
+		{
+			if (useflt) return 0;
+			if ((subtype == OP_LSH || subtype == OP_RSH) && (b->i < 0 || b->i >= 32))
+			{
+				return 0;
+			}
+			se_number_bitop(subtype, a, b, &r);
+		}
+		break;
+		default: return 0;
+	}
+
+	*a = r;
+	x->type = (uint16_t)(T_NUMBER << 8 | r.type);
+
+	return 1;
+}
+
+// 常量折叠：合并常量子表达式，移除只包含单个值的圆括号，左操作数为常量的短路运算直接取结果
+// 在链接之后执行（需要常量池），按各动作对元素帧栈的影响跟踪操作数是否为常量
+// 遇到无法确定栈影响的单元时停止折叠，其后的单元原样保留
+static void se_ctx_fold(seus_t *seus)
+{
+	if (seus->nus == 0)
+	{
+		return;
+	}
+
+	char *konst = (char*)se_alloc(seus->nus);
+	foldscope_t *scopes = (foldscope_t*)se_alloc((seus->nus + 1) * sizeof(foldscope_t));
+	foldjump_t *jumps = (foldjump_t*)se_alloc(seus->nus * sizeof(foldjump_t));
+	if (konst == 0L || scopes == 0L || jumps == 0L)
+	{
+		if (konst != 0L) se_free(konst);
+		if (scopes != 0L) se_free(scopes);
+		if (jumps != 0L) se_free(jumps);
+		return;
+	}
+
+	unit_t *us = seus->us;
+	int depth = 0, nscope = 0, njump = 0, w = 0, lost = 0;
+
+	scopes[nscope++] = (foldscope_t){ 0, 0, 1 }; // 语句本身的域
+
+	int i = 0;
+	for (; i <= seus->nus; ++i)
+	{
+		while (njump > 0 && jumps[njump - 1].target < i)
+		{	// 目标单元已输出，按折叠后的位置修正跳过的单元数
+			const foldjump_t *jump = &jumps[--njump];
+			us[jump->pos].idx = (uint16_t)(w - 1 - jump->pos);
+		}
+
+		if (i == seus->nus)
+		{
+			break;
+		}
+
+		const unit_t unit = us[i];
+		foldscope_t *scope = &scopes[nscope - 1];
+
+		if (lost)
+		{
+			us[w++] = unit;
+			continue;
+		}
+
+		switch (unit.act)
+		{
+			case SE_ACT_NUMBER:
+			{
+				konst[depth++] = unit.idx < seus->ncs;
+			}
+			break;
+			case SE_ACT_SYMBOL:
+			{
+				konst[depth++] = 0;
+			}
+			break;
+			case SE_ACT_SCOPE:
+			{
+				scopes[nscope++] = (foldscope_t){ w, depth, 0 };
+			}
+			break;
+			case SE_ACT_SIGN:
+			case SE_ACT_LNOT:
+			case SE_ACT_NOT:
+			{
+				if (depth <= scope->depth)
+				{
+					lost = 1;
+					break;
+				}
+				if (konst[depth - 1] && se_ctx_fold_unary(seus, &us[w - 1], &unit))
+				{
+					continue;
+				}
+				konst[depth - 1] = 0;
+			}
+			break;
+			case SE_ACT_BASECALC:
+			case SE_ACT_COMPARE:
+			case SE_ACT_BITOP:
+			{
+				if (depth < scope->depth + 2)
+				{
+					lost = 1;
+					break;
+				}
+				if (konst[depth - 1] && konst[depth - 2]
+					&& se_ctx_fold_binary(seus, &us[w - 2], &us[w - 1], &unit))
+				{
+					--depth;
+					--w;
+					continue;
+				}
+				konst[--depth - 1] = 0;
+			}
+			break;
+			case SE_ACT_ASSIGN:
+			case SE_ACT_CALC_ASS:
+			{
+				if (depth < scope->depth + 2)
+				{
+					lost = 1;
+					break;
+				}
+				konst[--depth - 1] = 0;
+			}
+			break;
+			case SE_ACT_JUMP:
+			{
+				if (depth <= scope->depth)
+				{
+					lost = 1;
+					break;
+				}
+				const int target = i + unit.idx;
+				if (konst[depth - 1])
+				{	// 左操作数为常量：决定结果时连同右操作数与运算符一并折叠，否则右操作数总会执行，无需短路单元
+					se_number_t *v = &seus->cs[us[w - 1].idx], r;
+					if (se_number_decide(SE_UNIT_SUBTYPE(unit) == OP_LOR_JMP ? OP_LOR : OP_LAND, v, &r))
+					{
+						*v = r;
+						us[w - 1].type = (uint16_t)(T_NUMBER << 8 | r.type);
+						i = target;
+					}
+					continue;
+				}
+				jumps[njump++] = (foldjump_t){ w, target };
+			}
+			break;
+			case SE_ACT_EXPARRAY:
+			{	// 解构的元素计入已接受的值
+				if (depth <= scope->depth)
+				{
+					lost = 1;
+					break;
+				}
+				konst[depth - 1] = 0;
+				scope->dirty = 1;
+			}
+			break;
+			case SE_ACT_COMMA:
+			{	// 域内最底部的值计入已接受的值
+				if (depth <= scope->depth)
+				{
+					lost = 1;
+					break;
+				}
+				memmove(konst + scope->depth, konst + scope->depth + 1, depth - scope->depth - 1);
+				--depth;
+				scope->dirty = 1;
+			}
+			break;
+			case SE_ACT_BRACKET:
+			case SE_ACT_FNCALL:
+			case SE_ACT_INDEX:
+			case SE_ACT_MAKEARRAY:
+			{
+				if (nscope <= 1 || depth < scope->depth)
+				{
+					lost = 1;
+					break;
+				}
+				--nscope;
+
+				if (unit.act == SE_ACT_BRACKET && !scope->dirty && depth == scope->depth + 1)
+				{	// 括号只包含一个值，移除起始单元且不输出结束单元
+					memmove(us + scope->pos, us + scope->pos + 1, (w - scope->pos - 1) * sizeof(unit_t));
+					--w;
+					continue;
+				}
+
+				depth = scope->depth;
+				if (unit.act == SE_ACT_FNCALL || unit.act == SE_ACT_INDEX)
+				{	// 同时弹出函数或数组
+					if (depth <= scopes[nscope - 1].depth)
+					{
+						lost = 1;
+						break;
+					}
+					--depth;
+				}
+				konst[depth++] = 0;
+			}
+			break;
+			default:
+			{
+				lost = 1;
+			}
+			break;
+		}
+
+		us[w++] = unit;
+	}
+
+	seus->nus = (uint16_t)w;
+
+	se_free(konst);
+	se_free(scopes);
+	se_free(jumps);
+}
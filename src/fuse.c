@@ -0,0 +1,140 @@
+#ifndef SE_CONTEXT_BUILD
+#error fuse.c is only available in context.c
+#endif
+
+// 超级指令：栈动作执行前将常见的单元序列融合为一个动作，省去中间值的元素帧栈进出、
+// 括号域状态的写入与逐单元的分派
+// 融合只改写序列首单元的动作编号，单元的数量与位置不变，短路单元的跳过数与寄存器指令的编译不受影响
+// 环境的融合集变化时递增版本，SEUS在下次执行前按新的融合集重新融合
+
+#define SE_FUSE_SAMPLES 4096 // SE_FUSE_PROFILE：累计的单元对数达到此值后选取融合集
+#define SE_FUSE_SHARE     32 // SE_FUSE_PROFILE：超级指令的每类单元对至少占全部单元对的1/SE_FUSE_SHARE
+
+#define SE_FUSE_BIT(act) (1u << ((act) - SE_ACT_FUSED)) // 融合集中超级指令对应的位
+#define SE_FUSE_FULLSET  (SE_FUSE_BIT(SE_ACT_LOAD_OP) | SE_FUSE_BIT(SE_ACT_LOAD2_OP) | SE_FUSE_BIT(SE_ACT_SCOPED))
+
+static inline int se_fuse_operand(int act)
+{
+	return act == SE_ACT_SYMBOL || act == SE_ACT_NUMBER;
+}
+
+static inline int se_fuse_binary(int act)
+{
+	return act == SE_ACT_BASECALC || act == SE_ACT_COMPARE || act == SE_ACT_BITOP
+		|| act == SE_ACT_ASSIGN || act == SE_ACT_CALC_ASS;
+}
+
+static inline int se_fuse_closing(int act)
+{
+	return act == SE_ACT_BRACKET || act == SE_ACT_FNCALL || act == SE_ACT_INDEX;
+}
+
+// 按环境的融合集融合SEUS，从左至右贪心匹配序列
+// 短路单元跳过的范围总是以完整的序列开始与结束，跳转不会落入序列内部
+static void se_ctx_fuse(ctxmemory_t *ctxmem, seus_t *seus)
+{
+	unit_t *us = seus->us;
+	const int n = seus->nus;
+	const uint32_t set = ctxmem->fuseset;
+
+	int i = 0;
+	for (; i < n; ++i)
+	{
+		us[i].act = (uint16_t)se_ctx_base_action(&us[i]);
+	}
+
+	for (i = 0; set != 0 && i < n; ++i)
+	{
+		const int a0 = us[i].act;
+		const int a1 = i + 1 < n ? us[i + 1].act : SE_ACT_NOP;
+		const int a2 = i + 2 < n ? us[i + 2].act : SE_ACT_NOP;
+
+		if ((set & SE_FUSE_BIT(SE_ACT_LOAD2_OP))
+			&& se_fuse_operand(a0) && se_fuse_operand(a1) && se_fuse_binary(a2))
+		{
+			us[i].act = SE_ACT_LOAD2_OP;
+			i += 2;
+		} else if ((set & SE_FUSE_BIT(SE_ACT_LOAD_OP))
+			&& se_fuse_operand(a0) && se_fuse_binary(a1))
+		{
+			us[i].act = SE_ACT_LOAD_OP;
+			i += 1;
+		} else if ((set & SE_FUSE_BIT(SE_ACT_SCOPED))
+			&& a0 == SE_ACT_SCOPE && SE_UNIT_SUBTYPE(us[i]) != OP_ARR_S
+			&& se_fuse_operand(a1) && se_fuse_closing(a2))
+		{
+			us[i].act = SE_ACT_SCOPED;
+			i += 2;
+		}
+	}
+
+	seus->fusegen = ctxmem->fusegen;
+}
+
+// 按单元类别汇总动作对，选取每类单元对都足够频繁的超级指令
+static uint32_t se_fuse_select(const uint32_t *pairs, uint64_t npairs)
+{
+	uint64_t opd_opd = 0, opd_bin = 0, scope_opd = 0, opd_close = 0;
+
+	int a = 0, b;
+	for (; a < SE_ACT_FUSED; ++a)
+	{
+		for (b = 0; b < SE_ACT_FUSED; ++b)
+		{
+			const uint64_t count = pairs[a * SE_ACT_FUSED + b];
+			if (se_fuse_operand(a) && se_fuse_operand(b)) opd_opd   += count;
+			if (se_fuse_operand(a) && se_fuse_binary(b))  opd_bin   += count;
+			if (a == SE_ACT_SCOPE  && se_fuse_operand(b)) scope_opd += count;
+			if (se_fuse_operand(a) && se_fuse_closing(b)) opd_close += count;
+		}
+	}
+
+#define SE_FUSE_FREQUENT(count) ((count) * SE_FUSE_SHARE >= npairs)
+	uint32_t set = 0;
+	if (SE_FUSE_FREQUENT(opd_bin))
+	{
+		set |= SE_FUSE_BIT(SE_ACT_LOAD_OP);
+		if (SE_FUSE_FREQUENT(opd_opd))
+		{
+			set |= SE_FUSE_BIT(SE_ACT_LOAD2_OP);
+		}
+	}
+	if (SE_FUSE_FREQUENT(scope_opd) && SE_FUSE_FREQUENT(opd_close))
+	{
+		set |= SE_FUSE_BIT(SE_ACT_SCOPED);
+	}
+#undef SE_FUSE_FREQUENT
+
+	return set;
+}
+
+// SE_FUSE_PROFILE：累计将要执行的SEUS中相邻单元的动作对，样本足够时选取融合集并结束统计
+static void se_fuse_profile(ctxmemory_t *ctxmem, const seus_t *seus)
+{
+	uint32_t *pairs = ctxmem->fuse_pairs;
+
+	int i = 1;
+	for (; i < seus->nus; ++i)
+	{
+		const int a = se_ctx_base_action(&seus->us[i - 1]);
+		const int b = se_ctx_base_action(&seus->us[i]);
+		++pairs[a * SE_ACT_FUSED + b];
+	}
+
+	if (seus->nus > 1)
+	{
+		ctxmem->fuse_npairs += seus->nus - 1;
+	}
+
+	if (ctxmem->fuse_npairs < SE_FUSE_SAMPLES)
+	{
+		return;
+	}
+
+	ctxmem->fuseset = se_fuse_select(pairs, ctxmem->fuse_npairs);
+	++ctxmem->fusegen;
+
+	se_free(ctxmem->fuse_pairs);
+	ctxmem->fuse_pairs  = 0L;
+	ctxmem->fuse_npairs = 0;
+}
@@ -2,147 +2,250 @@
 #error hashmap.c is only available in context.c
 #endif
 
-// SDBMHash function
-static inline uint32_t hash(const char *s)
+#define SE_HASHMAP_INITIAL 64 // 初始槽位数（2的幂）
+#define SE_HASHMAP_MIGRATE 8  // 扩容期间每次插入迁移的旧表槽位数
+
+// 64位乘法，返回128位结果的高低位异或
+static inline uint64_t hash_mum(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+	const uint64_t ha = a >> 32, la = (uint32_t)a;
+	const uint64_t hb = b >> 32, lb = (uint32_t)b;
+	const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	const uint64_t t = rl + (rm0 << 32);
+	const uint64_t lo = t + (rm1 << 32);
+	const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+	return lo ^ hi;
+#endif
+}
+
+static inline uint64_t hash_read(const char *p, size_t n)
+{
+	uint64_t v = 0;
+	memcpy(&v, p, n);
+	return v;
+}
+
+// wyhash风格的散列：每次读取8字节，以64位乘法混合
+static inline uint32_t hash(const char *s, size_t len)
 {
-    uint32_t _hash = 0;
-	while (*s)
+	uint64_t h = 0xa0761d6478bd642full ^ len;
+	for (; len >= 8; s += 8, len -= 8)
 	{
-    	_hash = (*s++) + (_hash << 6) + (_hash << 16) - _hash;
+		h = hash_mum(h ^ hash_read(s, 8), 0xe7037ed1a0b428dbull);
 	}
-    return (_hash & 0x7fffffff);
+	h = hash_mum(h ^ hash_read(s, len), 0x8ebc6af09c88c6e3ull);
+	return (uint32_t)(h ^ (h >> 32));
 }
 
-// 插入哈希表，键存在时覆盖
-static s2inode_t* hashmap_insert(hashmap_t *map, const char *s, uint16_t id)
+// 线性探测，返回键所在的槽位，键不存在时返回探测到的空槽位
+static inline s2inode_t* hashmap_probe(s2inode_t *table, size_t mask,
+	const char *s, size_t len, uint32_t h)
 {
-	assert(map != 0L);
-	assert(map->table != 0L);
-	assert(s != 0L);
-	assert(*s != '\0');
+	size_t i = h & mask;
+	for (;;)
+	{
+		s2inode_t *node = table + i;
+		if (node->str == 0L)
+		{
+			return node;
+		}
+		if (node->hash == h && node->len == len && memcmp(node->str, s, len) == 0)
+		{
+			return node;
+		}
+		i = (i + 1) & mask;
+	}
+}
 
-	uint32_t _hash = hash(s) % g_hashmap_size[map->size_id];
-	s2inode_t *node = map->table + _hash;
+static int hashmap_init(hashmap_t *map)
+{
+	memset(map, 0, sizeof(hashmap_t));
 
-	if (node->str == 0L)
-	{	// 表头为空，直接写入
-		node->str  = s;
-		node->id   = id;
-		node->next = 0L;
-		++map->used;
-		return node;
+	map->capacity = SE_HASHMAP_INITIAL;
+	map->table = (s2inode_t*)se_alloc(map->capacity * sizeof(s2inode_t));
+	if (map->table == 0L)
+	{
+		return 1;
 	}
 
-	while (node->next != 0L)
+	memset(map->table, 0, map->capacity * sizeof(s2inode_t));
+
+	return 0;
+}
+
+// 将旧表的至多n个槽位迁移到新表，全部迁移后释放旧表
+// 旧表的槽位迁移后保留原值，以免打断其余键的探测序列
+static void hashmap_migrate(hashmap_t *map, size_t n)
+{
+	const size_t mask = map->capacity - 1;
+
+	for (; n > 0 && map->migrated < map->old_capacity; --n, ++map->migrated)
 	{
-		if (strcmp(node->next->str, s) == 0)
-		{	// 键存在，覆写值
-			node->next->id = id;
-			return node->next;
+		const s2inode_t *node = map->old + map->migrated;
+		if (node->str == 0L)
+		{
+			continue;
+		}
+
+		s2inode_t *slot = hashmap_probe(map->table, mask, node->str, node->len, node->hash);
+		if (slot->str == 0L)
+		{	// 迁移期间重新插入的键以新表为准
+			*slot = *node;
 		}
-		node = node->next;
 	}
 
-	node->next = (s2inode_t*)se_alloc(sizeof(s2inode_t));
-	assert(node->next != 0L);
-	node = node->next;
+	if (map->migrated == map->old_capacity)
+	{
+		se_free(map->old);
+		map->old = 0L;
+		map->old_capacity = 0;
+		map->migrated = 0;
+	}
+}
+
+// 容量加倍，旧表在之后的插入中逐步迁移
+static void hashmap_grow(hashmap_t *map)
+{
+	if (map->old != 0L)
+	{
+		hashmap_migrate(map, map->old_capacity);
+	}
 
-	node->str  = s;
-	node->id   = id;
-	node->next = 0L;
+	const size_t capacity = map->capacity << 1;
+	s2inode_t *table = (s2inode_t*)se_alloc(capacity * sizeof(s2inode_t));
+	assert(table != 0L);
+	memset(table, 0, capacity * sizeof(s2inode_t));
 
-	return node;
+	map->old = map->table;
+	map->old_capacity = map->capacity;
+	map->migrated = 0;
+	map->table = table;
+	map->capacity = capacity;
 }
 
-static void hashmap_remove(hashmap_t *map, const char *s)
+static s2inode_t* hashmap_find_by_span(hashmap_t *map, const char *s, size_t len)
 {
 	assert(map != 0L);
 	assert(map->table != 0L);
 
-	if (s == 0L) return;
-	if (*s == '\0') return;
+	if (s == 0L || len == 0) return 0L;
 
-	uint32_t _hash = hash(s) % g_hashmap_size[map->size_id];
-	s2inode_t *node = map->table + _hash;
+	const uint32_t h = hash(s, len);
 
-	if (strcmp(node->str, s) == 0)
-	{	// 表头为空，直接写入
-		if (node->next != 0L)
-		{
-			s2inode_t *tmp = node->next;
-			node->str  = tmp->str;
-			node->id   = tmp->id;
-			node->next = node->next->next;
-			se_free(tmp);
-		} else
-		{
-			node->str = 0L;
-			node->id  = 0;
-			--map->used;
-		}
-		return;
+	s2inode_t *node = hashmap_probe(map->table, map->capacity - 1, s, len, h);
+	if (node->str != 0L)
+	{
+		return node;
 	}
 
-	while (node->next != 0L)
-	{
-		if (strcmp(node->next->str, s) == 0)
+	if (map->old != 0L)
+	{	// 尚未迁移的键
+		node = hashmap_probe(map->old, map->old_capacity - 1, s, len, h);
+		if (node->str != 0L)
 		{
-			s2inode_t *tmp = node->next;
-			node->next = node->next->next;
-			se_free(tmp);
-			return;
+			return node;
 		}
-		node = node->next;
 	}
+
+	return 0L;
 }
 
 static s2inode_t* hashmap_find_by_key(hashmap_t *map, const char *s)
+{
+	if (s == 0L) return 0L;
+
+	return hashmap_find_by_span(map, s, strlen(s));
+}
+
+// 插入哈希表，键存在时覆盖（键的内存由调用者持有）
+static s2inode_t* hashmap_insert(hashmap_t *map, const char *s, uint16_t id)
 {
 	assert(map != 0L);
 	assert(map->table != 0L);
+	assert(s != 0L);
+	assert(*s != '\0');
 
-	if (s == 0L) return 0L;
-	if (*s == '\0') return 0L;
-
-	uint32_t _hash = hash(s) % g_hashmap_size[map->size_id];
-	s2inode_t *node = map->table + _hash;
+	// 装载因子保持在3/4以下
+	if ((map->used + 1) * 4 > map->capacity * 3)
+	{
+		hashmap_grow(map);
+	}
+	if (map->old != 0L)
+	{
+		hashmap_migrate(map, SE_HASHMAP_MIGRATE);
+	}
 
-	if (node->str == 0L) return 0L;
+	const size_t len = strlen(s);
+	const uint32_t h = hash(s, len);
 
-	while (node != 0L)
+	s2inode_t *node = hashmap_probe(map->table, map->capacity - 1, s, len, h);
+	if (node->str == 0L)
 	{
-		if (strcmp(node->str, s) == 0)
+		const s2inode_t *prev = map->old != 0L
+			? hashmap_probe(map->old, map->old_capacity - 1, s, len, h) : 0L;
+		if (prev != 0L && prev->str != 0L)
+		{	// 键位于尚未迁移的槽位，提前迁移
+			*node = *prev;
+		} else
 		{
-			return node;
+			node->str  = s;
+			node->hash = h;
+			node->len  = (uint16_t)len;
+			node->id   = 0;
+			++map->used;
 		}
-		node = node->next;
 	}
 
-	return 0L;
+	node->id = id;
+
+	return node;
 }
 
-static s2inode_t* hashmap_find_by_value(hashmap_t *map, uint16_t id)
+static void hashmap_remove(hashmap_t *map, const char *s)
 {
 	assert(map != 0L);
 	assert(map->table != 0L);
 
-	int i = -1, bound = g_hashmap_size[map->size_id];
+	if (s == 0L) return;
+	if (*s == '\0') return;
 
-	while (++i < bound)
+	// 删除会移动槽位，先完成迁移
+	if (map->old != 0L)
 	{
-		s2inode_t *node = map->table + i;
-		if (node->str != 0L)
+		hashmap_migrate(map, map->old_capacity);
+	}
+
+	const size_t len = strlen(s);
+	const size_t mask = map->capacity - 1;
+	s2inode_t *node = hashmap_probe(map->table, mask, s, len, hash(s, len));
+	if (node->str == 0L)
+	{
+		return;
+	}
+
+	// 后移删除：将探测序列中之后的键前移，无需删除标记
+	size_t i = node - map->table, j = i;
+	for (;;)
+	{
+		j = (j + 1) & mask;
+		if (map->table[j].str == 0L)
 		{
-			while (node != 0L)
-			{
-				if (node->id == id)
-				{
-					return node;
-				}
-				node = node->next;
-			}
+			break;
+		}
+
+		const size_t k = map->table[j].hash & mask;
+		const int stay = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+		if (!stay)
+		{
+			map->table[i] = map->table[j];
+			i = j;
 		}
 	}
 
-	return 0L;
-}
\ No newline at end of file
+	memset(map->table + i, 0, sizeof(s2inode_t));
+	--map->used;
+}
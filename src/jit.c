@@ -0,0 +1,789 @@
+#ifndef SE_CONTEXT_BUILD
+#error jit.c is only available in context.c
+#endif
+
+// 本机代码层：以SE_EXEC_JIT执行的纯数值语句在执行SE_JIT_THRESHOLD次后编译为x86-64代码
+// 编译时按符号的当前值推测各值的类型，执行前逐个检查符号，类型不符时退回寄存器指令执行；
+// 整数溢出、除零、非有限的浮点结果与越界的移位均跳出本机代码，由解释执行给出与逐单元执行一致的结果或异常
+
+#define SE_JIT_THRESHOLD  64         // 编译本机代码前的执行次数
+#define SE_JIT_MAX_DEOPT  4          // 类型推测失败的最多次数，超过后不再编译
+#define SE_JIT_MAX_SYMS   64         // 单个语句的最多符号数
+#define SE_JIT_CHUNK      (64 << 10) // 代码区每次映射的字节数
+#define SE_JIT_CODE_LIMIT (4 << 20)  // 单个环境的代码区上限
+#define SE_JIT_RETRY      2          // 编译失败但可在符号重新绑定后重试
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define SE_JIT_X64
+#include <sys/mman.h>
+#endif
+
+// 本机代码入口：args为各符号的数值，结果的值写入out，成功返回0，需要解释执行时返回1
+typedef int (*se_jitfn_t)(const se_number_t *const *args, se_number_t *out);
+
+// 符号的推测类型
+typedef struct jitsym_s
+{
+	const unit_t *unit;
+	uint16_t type;
+} jitsym_t;
+
+// 已编译的语句（位于代码区，安装后只读，syms只保留实际的符号数）
+typedef struct jitcode_s
+{
+	se_jitfn_t fn;
+	int nsyms;
+	uint16_t type; // 结果的数值类型
+	jitsym_t syms[SE_JIT_MAX_SYMS];
+} jitcode_t;
+
+// 环境的代码区分块（记录本身位于内存池）
+typedef struct jitchunk_s
+{
+	struct jitchunk_s *next;
+	uint8_t *base;
+	size_t size;
+	size_t used;
+} jitchunk_t;
+
+// 取符号的数值，符号未绑定或不为有效数值时返回0L
+static const se_number_t* se_jit_symbol(ctxmemory_t *ctxmem, const unit_t *unit)
+{
+	if (unit->idx == 0 || unit->idx > ctxmem->idstorage_capacity)
+	{
+		return 0L;
+	}
+
+	const se_object_t *obj = &ctxmem->idstorage[unit->idx - 1];
+	while (obj->type == EO_OBJ)
+	{
+		obj = (const se_object_t*)obj->data;
+	}
+
+	if (obj->type != EO_NUM)
+	{
+		return 0L;
+	}
+
+	const se_number_t *num = (const se_number_t*)obj->data;
+	return num->nan || num->inf ? 0L : num;
+}
+
+#if defined(SE_JIT_X64)
+
+///-------- emitter --------
+
+// 待回填的rel32跳转
+typedef struct jitfixup_s
+{
+	int pos;    // rel32在代码中的位置
+	int target; // 目标指令（为-1时跳出本机代码）
+} jitfixup_t;
+
+typedef struct jitbuf_s
+{
+	uint8_t *code;
+	size_t size;
+	size_t capacity;
+	jitfixup_t *fixups; // 待回填的跳转
+	int nfixups;
+	int failed;     // 内存不足
+} jitbuf_t;
+
+static void jit_emit(jitbuf_t *jb, const uint8_t *bytes, size_t n)
+{
+	if (jb->size + n > jb->capacity)
+	{
+		size_t capacity = jb->capacity > 0 ? jb->capacity * 2 : 256;
+		while (capacity < jb->size + n)
+		{
+			capacity *= 2;
+		}
+		uint8_t *code = (uint8_t*)(jb->code != 0L
+			? se_realloc(jb->code, capacity) : se_alloc(capacity));
+		if (code == 0L)
+		{
+			jb->failed = 1;
+			return;
+		}
+		jb->code = code;
+		jb->capacity = capacity;
+	}
+
+	memcpy(jb->code + jb->size, bytes, n);
+	jb->size += n;
+}
+
+#define JIT(jb, ...) jit_emit(jb, (const uint8_t[]){ __VA_ARGS__ }, sizeof((const uint8_t[]){ __VA_ARGS__ }))
+
+static void jit_u32(jitbuf_t *jb, uint32_t v)
+{
+	jit_emit(jb, (const uint8_t*)&v, 4);
+}
+
+static void jit_u64(jitbuf_t *jb, uint64_t v)
+{
+	jit_emit(jb, (const uint8_t*)&v, 8);
+}
+
+#define JIT_EAX  0
+#define JIT_ECX  1
+#define JIT_XMM0 0
+#define JIT_XMM1 1
+
+#define JIT_CC_O  0x0
+#define JIT_CC_B  0x2
+#define JIT_CC_AE 0x3
+#define JIT_CC_E  0x4
+#define JIT_CC_NE 0x5
+#define JIT_CC_BE 0x6
+#define JIT_CC_A  0x7
+#define JIT_CC_L  0xc
+#define JIT_CC_GE 0xd
+#define JIT_CC_LE 0xe
+#define JIT_CC_G  0xf
+
+// 以[rbp+disp32]访问寄存器k的栈槽，op为前缀与操作码
+static void jit_slot(jitbuf_t *jb, const uint8_t *op, size_t n, int reg, int k)
+{
+	jit_emit(jb, op, n);
+	JIT(jb, (uint8_t)(0x85 | reg << 3));
+	jit_u32(jb, (uint32_t)(-8 * (k + 1)));
+}
+
+#define JIT_SLOT(jb, reg, k, ...) \
+	jit_slot(jb, (const uint8_t[]){ __VA_ARGS__ }, sizeof((const uint8_t[]){ __VA_ARGS__ }), reg, k)
+
+static void jit_load_i(jitbuf_t *jb, int reg, int k)  { JIT_SLOT(jb, reg, k, 0x8b); }
+static void jit_store_i(jitbuf_t *jb, int reg, int k) { JIT_SLOT(jb, reg, k, 0x89); }
+static void jit_load_q(jitbuf_t *jb, int k)           { JIT_SLOT(jb, JIT_EAX, k, 0x48, 0x8b); }
+static void jit_store_q(jitbuf_t *jb, int k)          { JIT_SLOT(jb, JIT_EAX, k, 0x48, 0x89); }
+static void jit_store_f(jitbuf_t *jb, int xmm, int k)  { JIT_SLOT(jb, xmm, k, 0xf2, 0x0f, 0x11); }
+
+// 取浮点值，整数以cvtsi2sd转换
+static void jit_load_f(jitbuf_t *jb, int xmm, int k, int type)
+{
+	if (type == EN_FLT)
+	{
+		JIT_SLOT(jb, xmm, k, 0xf2, 0x0f, 0x10);
+	} else
+	{
+		JIT_SLOT(jb, xmm, k, 0xf2, 0x0f, 0x2a);
+	}
+}
+
+// 条件成立时跳至目标指令（cc为负时无条件跳转）
+static void jit_branch(jitbuf_t *jb, int cc, int target)
+{
+	if (cc < 0)
+	{
+		JIT(jb, 0xe9);
+	} else
+	{
+		JIT(jb, 0x0f, (uint8_t)(0x80 | cc));
+	}
+
+	const size_t size = (jb->nfixups + 1) * sizeof(jitfixup_t);
+	jitfixup_t *fixups = (jitfixup_t*)(jb->fixups != 0L
+		? se_realloc(jb->fixups, size) : se_alloc(size));
+	if (fixups == 0L)
+	{
+		jb->failed = 1;
+		return;
+	}
+	jb->fixups = fixups;
+	jb->fixups[jb->nfixups++] = (jitfixup_t){ (int)jb->size, target };
+	jit_u32(jb, 0);
+}
+
+// 条件成立时跳出本机代码
+static void jit_bail(jitbuf_t *jb, int cc)
+{
+	jit_branch(jb, cc, -1);
+}
+
+// xmm0不为有限值时跳出（结果将带有inf或nan标志）
+static void jit_check_finite(jitbuf_t *jb)
+{
+	JIT(jb, 0x66, 0x48, 0x0f, 0x7e, 0xc0); // movq rax, xmm0
+	JIT(jb, 0x48, 0xb9);                   // mov rcx, imm64
+	jit_u64(jb, 0x7ff0000000000000ull);
+	JIT(jb, 0x48, 0x21, 0xc8);             // and rax, rcx
+	JIT(jb, 0x48, 0x39, 0xc8);             // cmp rax, rcx
+	jit_bail(jb, JIT_CC_E);
+}
+
+// al写入eax并存入栈槽
+static void jit_store_bool(jitbuf_t *jb, int k)
+{
+	JIT(jb, 0x0f, 0xb6, 0xc0); // movzx eax, al
+	jit_store_i(jb, JIT_EAX, k);
+}
+
+///-------- code generation --------
+
+// 生成二元运算，vt为各寄存器的数值类型，不支持的运算返回1
+static int jit_binary(jitbuf_t *jb, const reginst_t *in, uint16_t *vt)
+{
+	const int a = in->a, b = in->b;
+	const int useflt = vt[a] == EN_FLT || vt[b] == EN_FLT;
+
+	switch (in->op)
+	{
+		case SE_ACT_BASECALC:
+		{
+			if (useflt)
+			{
+				if (in->sub == OP_MOD)
+				{	// 必然抛出异常
+					return 1;
+				}
+				jit_load_f(jb, JIT_XMM0, a, vt[a]);
+				jit_load_f(jb, JIT_XMM1, b, vt[b]);
+				switch (in->sub)
+				{
+					case OP_ADD: JIT(jb, 0xf2, 0x0f, 0x58, 0xc1); break; // addsd xmm0, xmm1
+					case OP_SUB: JIT(jb, 0xf2, 0x0f, 0x5c, 0xc1); break; // subsd xmm0, xmm1
+					case OP_MUL: JIT(jb, 0xf2, 0x0f, 0x59, 0xc1); break; // mulsd xmm0, xmm1
+					case OP_DIV: JIT(jb, 0xf2, 0x0f, 0x5e, 0xc1); break; // divsd xmm0, xmm1
+				}
+				jit_check_finite(jb);
+				jit_store_f(jb, JIT_XMM0, a);
+				vt[a] = EN_FLT;
+				break;
+			}
+
+			jit_load_i(jb, JIT_EAX, a);
+			jit_load_i(jb, JIT_ECX, b);
+			switch (in->sub)
+			{
+				case OP_ADD: JIT(jb, 0x01, 0xc8); jit_bail(jb, JIT_CC_O); break;       // add eax, ecx
+				case OP_SUB: JIT(jb, 0x29, 0xc8); jit_bail(jb, JIT_CC_O); break;       // sub eax, ecx
+				case OP_MUL: JIT(jb, 0x0f, 0xaf, 0xc1); jit_bail(jb, JIT_CC_O); break; // imul eax, ecx
+				case OP_DIV:
+				case OP_MOD:
+				{
+					JIT(jb, 0x85, 0xc9);               // test ecx, ecx
+					jit_bail(jb, JIT_CC_E);
+					JIT(jb, 0x83, 0xf9, 0xff);         // cmp ecx, -1
+					JIT(jb, 0x75, 0x0b);               // jne +11
+					JIT(jb, 0x3d, 0x00, 0x00, 0x00, 0x80); // cmp eax, INT32_MIN
+					jit_bail(jb, JIT_CC_E);
+					JIT(jb, 0x99, 0xf7, 0xf9);         // cdq; idiv ecx
+					if (in->sub == OP_MOD)
+					{
+						JIT(jb, 0x89, 0xd0);           // mov eax, edx
+					}
+				}
+				break;
+			}
+			jit_store_i(jb, JIT_EAX, a);
+			vt[a] = EN_DEC;
+		}
+		break;
+		case SE_ACT_COMPARE:
+		{
+			if (in->sub == OP_LAND || in->sub == OP_LOR)
+			{
+				if (useflt)
+				{
+					jit_load_f(jb, JIT_XMM0, a, vt[a]);
+					jit_load_f(jb, JIT_XMM1, b, vt[b]);
+					JIT(jb, 0x66, 0x0f, 0x57, 0xd2); // xorpd xmm2, xmm2
+					JIT(jb, 0x66, 0x0f, 0x2e, 0xc2); // ucomisd xmm0, xmm2
+					JIT(jb, 0x0f, 0x95, 0xc0);       // setne al
+					JIT(jb, 0x66, 0x0f, 0x2e, 0xca); // ucomisd xmm1, xmm2
+					JIT(jb, 0x0f, 0x95, 0xc1);       // setne cl
+				} else
+				{
+					jit_load_i(jb, JIT_EAX, a);
+					jit_load_i(jb, JIT_ECX, b);
+					JIT(jb, 0x85, 0xc0, 0x0f, 0x95, 0xc0); // test eax, eax; setne al
+					JIT(jb, 0x85, 0xc9, 0x0f, 0x95, 0xc1); // test ecx, ecx; setne cl
+				}
+				if (in->sub == OP_LAND)
+				{
+					JIT(jb, 0x20, 0xc8); // and al, cl
+				} else
+				{
+					JIT(jb, 0x08, 0xc8); // or al, cl
+				}
+				jit_store_bool(jb, a);
+				vt[a] = EN_DEC;
+				break;
+			}
+
+			int cc;
+			if (useflt)
+			{	// 操作数均为有限值，ucomisd不会出现无序的结果
+				jit_load_f(jb, JIT_XMM0, a, vt[a]);
+				jit_load_f(jb, JIT_XMM1, b, vt[b]);
+				JIT(jb, 0x66, 0x0f, 0x2e, 0xc1); // ucomisd xmm0, xmm1
+				switch (in->sub)
+				{
+					case OP_GTR: cc = JIT_CC_A;  break;
+					case OP_GEQ: cc = JIT_CC_AE; break;
+					case OP_LSS: cc = JIT_CC_B;  break;
+					case OP_LEQ: cc = JIT_CC_BE; break;
+					case OP_EQU: cc = JIT_CC_E;  break;
+					default:     cc = JIT_CC_NE; break;
+				}
+			} else
+			{
+				jit_load_i(jb, JIT_EAX, a);
+				jit_load_i(jb, JIT_ECX, b);
+				JIT(jb, 0x39, 0xc8); // cmp eax, ecx
+				switch (in->sub)
+				{
+					case OP_GTR: cc = JIT_CC_G;  break;
+					case OP_GEQ: cc = JIT_CC_GE; break;
+					case OP_LSS: cc = JIT_CC_L;  break;
+					case OP_LEQ: cc = JIT_CC_LE; break;
+					case OP_EQU: cc = JIT_CC_E;  break;
+					default:     cc = JIT_CC_NE; break;
+				}
+			}
+			JIT(jb, 0x0f, (uint8_t)(0x90 | cc), 0xc0); // setcc al
+			jit_store_bool(jb, a);
+			vt[a] = EN_DEC;
+		}
+		break;
+		case SE_ACT_BITOP:
+		{
+			if (useflt)
+			{	// 必然抛出异常
+				return 1;
+			}
+			jit_load_i(jb, JIT_EAX, a);
+			jit_load_i(jb, JIT_ECX, b);
+			switch (in->sub)
+			{
+				case OP_LSH:
+				case OP_RSH:
+				{	// 移位数不在[0, 31]内时由解释执行
+					JIT(jb, 0x83, 0xf9, 0x1f); // cmp ecx, 31
+					jit_bail(jb, JIT_CC_A);
+					if (in->sub == OP_LSH)
+					{
+						JIT(jb, 0xd3, 0xe0); // shl eax, cl
+					} else
+					{
+						JIT(jb, 0xd3, 0xf8); // sar eax, cl
+					}
+				}
+				break;
+				case OP_AND: JIT(jb, 0x21, 0xc8); break; // and eax, ecx
+				case OP_XOR: JIT(jb, 0x31, 0xc8); break; // xor eax, ecx
+				case OP_OR:  JIT(jb, 0x09, 0xc8); break; // or eax, ecx
+			}
+			jit_store_i(jb, JIT_EAX, a);
+		}
+		break;
+		default: return 1;
+	}
+
+	return 0;
+}
+
+// 生成一元运算
+static int jit_unary(jitbuf_t *jb, const reginst_t *in, uint16_t *vt)
+{
+	const int a = in->a;
+
+	switch (in->op)
+	{
+		case SE_ACT_SIGN:
+		{
+			if (in->sub != OP_NL)
+			{
+				break;
+			}
+			if (vt[a] == EN_FLT)
+			{
+				jit_load_q(jb, a);
+				JIT(jb, 0x48, 0x0f, 0xba, 0xf8, 0x3f); // btc rax, 63
+				jit_store_q(jb, a);
+			} else
+			{	// INT32_MIN取负时带有inf标志
+				jit_load_i(jb, JIT_EAX, a);
+				JIT(jb, 0xf7, 0xd8); // neg eax
+				jit_bail(jb, JIT_CC_O);
+				jit_store_i(jb, JIT_EAX, a);
+			}
+		}
+		break;
+		case SE_ACT_LNOT:
+		{
+			if (vt[a] == EN_FLT)
+			{
+				jit_load_f(jb, JIT_XMM0, a, EN_FLT);
+				JIT(jb, 0x66, 0x0f, 0x57, 0xc9); // xorpd xmm1, xmm1
+				JIT(jb, 0x66, 0x0f, 0x2e, 0xc1); // ucomisd xmm0, xmm1
+			} else
+			{
+				jit_load_i(jb, JIT_EAX, a);
+				JIT(jb, 0x85, 0xc0); // test eax, eax
+			}
+			JIT(jb, 0x0f, 0x94, 0xc0); // sete al
+			jit_store_bool(jb, a);
+			vt[a] = EN_DEC;
+		}
+		break;
+		case SE_ACT_NOT:
+		{
+			if (vt[a] == EN_FLT)
+			{	// 必然抛出异常
+				return 1;
+			}
+			jit_load_i(jb, JIT_EAX, a);
+			JIT(jb, 0xf7, 0xd0); // not eax
+			jit_store_i(jb, JIT_EAX, a);
+		}
+		break;
+		default: return 1;
+	}
+
+	return 0;
+}
+
+// 生成语句的本机代码，语句不是纯数值表达式时返回1，符号不为有效数值时返回SE_JIT_RETRY
+static int jit_generate(ctxmemory_t *ctxmem, seus_t *seus, const regcode_t *code,
+	jitbuf_t *jb, jitcode_t *desc)
+{
+	uint16_t *vt = (uint16_t*)se_alloc((code->nregs + 1) * sizeof(uint16_t));
+	char *vsym = (char*)se_alloc(code->nregs + 1);
+	int *offset = (int*)se_alloc((code->ninst + 1) * sizeof(int)); // 各指令在代码中的位置
+	if (vt == 0L || vsym == 0L || offset == 0L)
+	{
+		if (vt != 0L) se_free(vt);
+		if (vsym != 0L) se_free(vsym);
+		if (offset != 0L) se_free(offset);
+		return 1;
+	}
+
+	desc->nsyms = 0;
+
+	// push rbp; mov rbp, rsp; sub rsp, imm32
+	JIT(jb, 0x55, 0x48, 0x89, 0xe5, 0x48, 0x81, 0xec);
+	jit_u32(jb, (uint32_t)((code->nregs * 8 + 15) & ~15));
+
+	int state = 0, i = 0;
+	for (; i < code->ninst && state == 0; ++i)
+	{
+		const reginst_t *in = &code->inst[i];
+		const int a = in->a;
+
+		offset[i] = (int)jb->size;
+
+		switch (in->op)
+		{
+			case SE_ACT_JUMP:
+			{	// 左操作数换为其真值（逻辑运算只取真值），决定结果时跳至运算符之后
+				if (vt[a] == EN_FLT)
+				{
+					jit_load_f(jb, JIT_XMM0, a, EN_FLT);
+					JIT(jb, 0x66, 0x0f, 0x57, 0xc9); // xorpd xmm1, xmm1
+					JIT(jb, 0x66, 0x0f, 0x2e, 0xc1); // ucomisd xmm0, xmm1
+				} else
+				{
+					jit_load_i(jb, JIT_EAX, a);
+					JIT(jb, 0x85, 0xc0); // test eax, eax
+				}
+				JIT(jb, 0x0f, 0x95, 0xc0); // setne al
+				jit_store_bool(jb, a);
+				JIT(jb, 0x85, 0xc0);       // test eax, eax
+				jit_branch(jb, in->sub == OP_LAND_JMP ? JIT_CC_E : JIT_CC_NE, in->b);
+				vt[a] = EN_DEC;
+				vsym[a] = 0;
+			}
+			break;
+			case SE_ACT_NUMBER:
+			{
+				const se_number_t num = se_ctx_literal(seus, in->unit);
+				if (num.nan || num.inf)
+				{
+					state = 1;
+					break;
+				}
+				if (num.type == EN_FLT)
+				{
+					uint64_t bits;
+					memcpy(&bits, &num.f, sizeof(bits));
+					JIT(jb, 0x48, 0xb8); // mov rax, imm64
+					jit_u64(jb, bits);
+					jit_store_q(jb, a);
+				} else
+				{
+					JIT_SLOT(jb, 0, a, 0xc7); // mov dword [rbp+disp32], imm32
+					jit_u32(jb, (uint32_t)num.i);
+				}
+				vt[a] = num.type;
+				vsym[a] = 0;
+			}
+			break;
+			case SE_ACT_SYMBOL:
+			{
+				const se_number_t *num = se_jit_symbol(ctxmem, in->unit);
+				if (num == 0L || desc->nsyms == SE_JIT_MAX_SYMS)
+				{
+					state = num == 0L ? SE_JIT_RETRY : 1;
+					break;
+				}
+				const int s = desc->nsyms++;
+				desc->syms[s] = (jitsym_t){ in->unit, num->type };
+
+				JIT(jb, 0x48, 0x8b, 0x87); // mov rax, [rdi+disp32]
+				jit_u32(jb, (uint32_t)(s * sizeof(void*)));
+				if (num->type == EN_FLT)
+				{
+					JIT(jb, 0x48, 0x8b, 0x00); // mov rax, [rax]
+					jit_store_q(jb, a);
+				} else
+				{
+					JIT(jb, 0x8b, 0x00); // mov eax, [rax]
+					jit_store_i(jb, JIT_EAX, a);
+				}
+				vt[a] = num->type;
+				vsym[a] = 1;
+			}
+			break;
+			case SE_ACT_SIGN:
+			case SE_ACT_LNOT:
+			case SE_ACT_NOT:
+			{
+				state = jit_unary(jb, in, vt);
+				vsym[a] = 0;
+			}
+			break;
+			default:
+			{
+				state = jit_binary(jb, in, vt);
+				vsym[a] = 0;
+			}
+			break;
+		}
+	}
+
+	// 结果为符号本身时，逐单元执行的结果是符号的引用而非数值
+	if (state == 0 && vsym[code->result])
+	{
+		state = 1;
+	}
+
+	if (state == 0)
+	{
+		desc->type = vt[code->result];
+
+		offset[code->ninst] = (int)jb->size;
+		jit_load_q(jb, code->result);
+		JIT(jb, 0x48, 0x89, 0x06); // mov [rsi], rax
+		JIT(jb, 0x31, 0xc0);       // xor eax, eax
+		JIT(jb, 0xc9, 0xc3);       // leave; ret
+
+		const int32_t bail = (int32_t)jb->size;
+		JIT(jb, 0xb8, 0x01, 0x00, 0x00, 0x00); // mov eax, 1
+		JIT(jb, 0xc9, 0xc3);                   // leave; ret
+
+		int k = 0;
+		for (; k < jb->nfixups && !jb->failed; ++k)
+		{
+			const jitfixup_t *fix = &jb->fixups[k];
+			const int32_t to  = fix->target < 0 ? bail : offset[fix->target];
+			const int32_t rel = to - (fix->pos + 4);
+			memcpy(jb->code + fix->pos, &rel, 4);
+		}
+	}
+
+	se_free(vt);
+	se_free(vsym);
+	se_free(offset);
+
+	return state != 0 ? state : jb->failed;
+}
+
+// 将描述与代码复制到代码区，代码区在写入期间不可执行
+static const jitcode_t* jit_install(ctxmemory_t *ctxmem, const jitcode_t *desc, const jitbuf_t *jb)
+{
+	const size_t used = offsetof(jitcode_t, syms) + desc->nsyms * sizeof(jitsym_t);
+	const size_t head = (used + 15) & ~(size_t)15;
+	const size_t size = (head + jb->size + 15) & ~(size_t)15;
+
+	jitchunk_t *chunk = ctxmem->jit_code;
+	if (chunk == 0L || chunk->size - chunk->used < size)
+	{
+		const size_t mapped = size > SE_JIT_CHUNK ? (size + 4095) & ~(size_t)4095 : SE_JIT_CHUNK;
+		if (ctxmem->jit_mapped + mapped > SE_JIT_CODE_LIMIT)
+		{
+			return 0L;
+		}
+
+		void *base = mmap(0L, mapped, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (base == MAP_FAILED)
+		{
+			return 0L;
+		}
+
+		chunk = (jitchunk_t*)se_alloc(sizeof(jitchunk_t));
+		if (chunk == 0L)
+		{
+			munmap(base, mapped);
+			return 0L;
+		}
+
+		chunk->next = ctxmem->jit_code;
+		chunk->base = (uint8_t*)base;
+		chunk->size = mapped;
+		chunk->used = 0;
+		ctxmem->jit_code = chunk;
+		ctxmem->jit_mapped += mapped;
+	}
+
+	if (mprotect(chunk->base, chunk->size, PROT_READ | PROT_WRITE) != 0)
+	{
+		return 0L;
+	}
+
+	const size_t offset = chunk->used;
+	uint8_t *p = chunk->base + offset;
+	jitcode_t *installed = (jitcode_t*)p;
+	memcpy(installed, desc, used);
+	memcpy(p + head, jb->code, jb->size);
+	installed->fn = (se_jitfn_t)(void*)(p + head);
+	chunk->used += size;
+
+	if (mprotect(chunk->base, chunk->size, PROT_READ | PROT_EXEC) != 0)
+	{	// 撤销本次写入并再次尝试恢复为可执行
+		chunk->used = offset;
+		if (mprotect(chunk->base, chunk->size, PROT_READ | PROT_EXEC) != 0)
+		{	// 仅含本次代码的分块直接解除映射，否则分块中已编译的语句无法执行，本环境不再执行本机代码
+			if (offset == 0)
+			{
+				ctxmem->jit_code = chunk->next;
+				ctxmem->jit_mapped -= chunk->size;
+				munmap(chunk->base, chunk->size);
+				se_free(chunk);
+			} else
+			{
+				ctxmem->jit_disabled = 1;
+			}
+		}
+		return 0L;
+	}
+	__builtin___clear_cache((char*)p + head, (char*)p + head + jb->size);
+
+	return installed;
+}
+
+// 编译语句，成功时代码存入out，失败时返回值同jit_generate
+static int se_jit_compile(ctxmemory_t *ctxmem, seus_t *seus, const regcode_t *code, const jitcode_t **out)
+{
+	jitbuf_t jb = { 0 };
+	jitcode_t desc;
+
+	int state = jit_generate(ctxmem, seus, code, &jb, &desc);
+	if (state == 0)
+	{
+		*out = jit_install(ctxmem, &desc, &jb);
+		state = *out == 0L;
+	}
+
+	if (jb.code != 0L) se_free(jb.code);
+	if (jb.fixups != 0L) se_free(jb.fixups);
+
+	return state;
+}
+
+// 解除代码区的映射（已编译的语句在环境销毁前不回收）
+static void se_jit_release(ctxmemory_t *ctxmem)
+{
+	jitchunk_t *chunk = ctxmem->jit_code;
+	for (; chunk != 0L; chunk = chunk->next)
+	{
+		munmap(chunk->base, chunk->size);
+	}
+	ctxmem->jit_code = 0L;
+	ctxmem->jit_mapped = 0;
+}
+
+#else
+
+static int se_jit_compile(ctxmemory_t *ctxmem, seus_t *seus, const regcode_t *code, const jitcode_t **out)
+{	// 平台不支持时始终解释执行
+	(void)ctxmem;
+	(void)seus;
+	(void)code;
+	(void)out;
+	return 1;
+}
+
+static void se_jit_release(ctxmemory_t *ctxmem)
+{
+	(void)ctxmem;
+}
+
+#endif
+
+// 以本机代码执行语句，成功时结果存入out；未编译、类型推测失败或需要解释执行时返回1，此时没有副作用
+static int se_jit_exec(se_context_t *ctx, seus_t *seus, regcode_t *code, se_object_t *out)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (code->tier < 0 || ctxmem->jit_disabled)
+	{
+		return 1;
+	}
+
+	if (code->jit == 0L)
+	{
+		if (++code->hits < SE_JIT_THRESHOLD)
+		{
+			return 1;
+		}
+
+		const jitcode_t *compiled = 0L;
+		const int state = se_jit_compile(ctxmem, seus, code, &compiled);
+		if (state != 0)
+		{	// 符号可能尚未绑定为数值，稍后重试；其余情况不再编译
+			code->hits = 0;
+			if (state != SE_JIT_RETRY || ++code->ndeopt > SE_JIT_MAX_DEOPT)
+			{
+				code->tier = -1;
+			}
+			return 1;
+		}
+		code->jit = compiled;
+	}
+
+	const jitcode_t *jit = (const jitcode_t*)code->jit;
+
+	const se_number_t *args[SE_JIT_MAX_SYMS];
+	int i = 0;
+	for (; i < jit->nsyms; ++i)
+	{
+		args[i] = se_jit_symbol(ctxmem, jit->syms[i].unit);
+		if (args[i] == 0L || args[i]->type != jit->syms[i].type)
+		{	// 类型推测失败，按新的类型重新编译
+			code->jit  = 0L;
+			code->hits = 0;
+			if (++code->ndeopt > SE_JIT_MAX_DEOPT)
+			{
+				code->tier = -1;
+			}
+			return 1;
+		}
+	}
+
+	se_number_t *num = &ctxmem->resnum;
+	if (jit->fn(args, num) != 0)
+	{
+		return 1;
+	}
+
+	num->type = jit->type;
+	num->inf  = 0;
+	num->nan  = 0;
+
+	*out = wrap2obj(num, EO_NUM);
+
+	return 0;
+}
@@ -25,8 +25,15 @@ const char* next_token(const char *str, token_t *token, tokstate_t *state)
 	assert(token != 0L);
 	assert(state != 0L);
 
-	int toktype = predict(str);
-	se_getter(toktype)(str, token);
+	switch (predict(str))
+	{
+		case T_NUMBER:   get_number  (str, token); break;
+		case T_SYMBOL:   get_symbol  (str, token); break;
+		case T_OPERATOR: get_operator(str, token); break;
+		case T_INDENT:   get_indent  (str, token); break;
+		case T_NULL:     get_null    (str, token); break;
+		default:         get_invalid (str, token); break;
+	}
 
 	if (token->type == T_NULL) 
 	{
@@ -170,15 +177,10 @@ const char* str2tokens(const char *str, token_t **ptoks, int *psize)
 	assert(ptoks != 0L);
 	assert(psize != 0L);
 
-	int n = 0, i = 0, errors = 0;
+	// 单趟扫描，TOKENS容量按需倍增，不再预先统计语句长度
+	int n = 16, i = 0, errors = 0;
 	const char *p = str;
 
-	while (*p != ';' && *p != '\0')
-	{
-		++n;
-		++p;
-	}
-
 	token_t *tokens = (token_t*)se_alloc(n * sizeof(token_t));
 	assert(tokens != 0L);
 
@@ -222,6 +224,12 @@ const char* str2tokens(const char *str, token_t **ptoks, int *psize)
 				}
 				token.sub_type = op;
 			}
+			if (i == n)
+			{
+				n <<= 1;
+				tokens = (token_t*)se_realloc(tokens, n * sizeof(token_t));
+				assert(tokens != 0L);
+			}
 			tokens[i++] = token;
 		}
 	}
@@ -230,46 +238,237 @@ const char* str2tokens(const char *str, token_t **ptoks, int *psize)
 	{
 		*psize = 0;
 		*ptoks = 0L;
+		se_free(tokens);
 	} else
 	{
 		*psize = i;
-		*ptoks = (token_t*)se_alloc(i * sizeof(token_t));
-		memcpy(*ptoks, tokens, i * sizeof(token_t));
+		*ptoks = tokens;
 	}
 
-	se_free(tokens);
-
 	return p;
 }
 
-// 将TOKENS转换为逆波兰表达式
-unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
+// SEUS检查状态，模拟语句执行中的栈情况
+typedef struct seuscheck_s
 {
-	assert(psize != 0L);
+	int ef, nef;          // 入栈的元素帧 element frame
+	int vf, nvf;          // 逗号已接受的值 accepted value frame
+	int p, nss;           // 括号域栈顶与最大深度
+	scopestate_t *ss;     // 括号域状态
+	int failed;           // 检查是否已失败（单趟编译时推迟抛出）
+	se_exception_t error; // 推迟抛出的异常
+} seuscheck_t;
+
+static void seus_check_init(seuscheck_t *chk, scopestate_t *ss)
+{
+	chk->ef = chk->nef = -1;
+	chk->vf = chk->nvf = -1;
+	chk->p = -1;
+	chk->nss = 1;
+	chk->ss = ss;
+	chk->failed = 0;
+
+	ss[++chk->p] = (scopestate_t){ chk->ef + 1, 0 };
+}
 
-	if (tokens == 0L || ntok <= 0)
+// 模拟执行第i个单元，出错时抛出异常并返回1
+static int seus_check_step(seuscheck_t *chk, const unit_t *e, int i)
+{
+	scopestate_t *ss = chk->ss;
+
+	if ((e->type >> 8 & 0xf) == T_OPERATOR)
+	switch (e->type & 0xff)
 	{
-		se_throw(UnknownError, ArgumentErrorInCSrc, 0, 0);
-		*psize = 0;
-		return 0L;
+		case OP_BRE_S:
+		case OP_ARG_S:
+		case OP_IDX_S:
+		case OP_ARR_S:
+		{	// 压入新的括号域
+			ss[++chk->p] = (scopestate_t){ chk->ef + 1, 0 };
+			if (chk->p >= chk->nss)
+			{
+				chk->nss = chk->p + 1;
+			}
+		}
+		return 0;
+		case OP_BRE:
+		case OP_ARG:
+		case OP_IDX:
+		case OP_ARR:
+		{
+			int nele;
+			int p = chk->p;
+
+			if (chk->ef > ss[p].sframe)
+			{
+				se_throw(SyntaxError, MissingComma, i, 0);
+				return 1;
+			} else if (chk->ef < ss[p].sframe)
+			{
+				if (ss[p].accept > 0)
+				{
+					se_throw(SyntaxError, TooManyCommas, i, 0);
+					return 1;
+				} else
+				{
+					nele = 0;
+				}
+			} else if (ss[p].accept > 0)
+			{
+				nele = ss[p].accept + 1;
+			} else
+			{
+				nele = 1;
+			}
+
+			int op = e->type & 0xff;
+
+			if (nele == 0)
+			{
+				if (op == OP_IDX)
+				{
+					se_throw(IndexError, NoIndex, i, 0);
+					return 1;
+				} else
+				{
+					++chk->ef;
+					if (chk->ef > chk->nef)
+					{
+						chk->nef = chk->ef;
+					}
+				}
+			} else
+			{
+				chk->vf -= ss[p].accept;
+				if (chk->vf < -1)
+				{
+					se_throw(SyntaxError, InvalidSyntax, i, 0);
+					return 1;
+				}
+			}
+
+			if (op == OP_IDX)
+			{
+				--chk->ef;
+				if (chk->ef < 0)
+				{
+					se_throw(IndexError, MissingArray, i, 0);
+					return 1;
+				}
+			}
+
+			if (op == OP_ARG)
+			{
+				--chk->ef;
+				if (chk->ef < 0)
+				{
+					se_throw(RuntimeError, ExpectFunction, i, 0);
+					return 1;
+				}
+			}
+
+			--chk->p;
+
+			if (chk->p < 0)
+			{
+				se_throw(SyntaxError, InvalidSyntax, i, 0);
+				return 1;
+			}
+		}
+		return 0;
+		case OP_CME:
+		{
+			if (chk->ef >= ss[chk->p].sframe)
+			{
+				++ss[chk->p].accept;
+				--chk->ef;
+				++chk->vf;
+				if (chk->vf > chk->nvf)
+				{
+					chk->nvf = chk->vf;
+				}
+			} else
+			{
+				se_throw(SyntaxError, TooManyCommas, i, 0);
+				return 1;
+			}
+		}
+		return 0;
+		case OP_PL:
+		case OP_NL:
+		case OP_EPA: // uncertain
+		case OP_NOT:
+		case OP_LNOT:
+		{
+			if (chk->ef < ss[chk->p].sframe)
+			{
+				se_throw(SyntaxError, MissingOperand, i, 0);
+				return 1;
+			}
+		}
+		return 0;
+		default:
+		{
+			--chk->ef;
+			if (chk->ef < ss[chk->p].sframe)
+			{
+				se_throw(SyntaxError, MissingOperand, i, 0);
+				return 1;
+			}
+		}
+		return 0;
 	}
 
-	se_exception_t last_exception = { 0 };
-	se_catch_any(&last_exception);
+	++chk->ef;
+	if (chk->ef > chk->nef)
+	{
+		chk->nef = chk->ef;
+	}
 
-	int size = ntok, i = 0;
-	unit_t *rp = se_alloc(size * sizeof(unit_t));
-	assert(rp != 0L);
+	return 0;
+}
 
+// 检查全部n个单元执行后恰好留下一个值
+static int seus_check_done(seuscheck_t *chk, int n)
+{
+	if (chk->ef != 0)
+	{
+		se_throw(SyntaxError, InvalidSyntax, n, chk->ef);
+		return 1;
+	}
+
+	return 0;
+}
+
+// 单趟编译中检查刚输出的单元，异常推迟到调度场算法结束后抛出
+// 以保证括号错误优先于栈检查错误，与两趟编译的结果一致
+// 输出位置已与符号栈重叠时（存在未闭合的括号）不再检查，由调用者按最终结果重新检查
+static inline void seus_check_emit(seuscheck_t *chk, const unit_t *rp, int p, int q)
+{
+	if (chk == 0L || chk->failed || p >= q) return;
+
+	if (seus_check_step(chk, rp + p, p) != 0)
+	{
+		chk->failed = 1;
+		se_catch_any(&chk->error);
+	}
+}
+
+// 调度场算法，逆波兰表达式与符号栈共用rp（容量为size）
+// chk不为0L时，每输出一个单元即交由其检查，输出与符号栈发生重叠时返回1
+static int toks_shunt(const token_t *tokens, int size, unit_t *rp, seuscheck_t *chk)
+{
 	int p = -1;   // pointer to RPN
 	int q = size; // pointer to stack
 
-	for (i = 0; i < ntok; ++i)
+	int i = 0;
+	for (i = 0; i < size; ++i)
 	{
 		token_t tok = tokens[i];
 		if (tok.type != T_OPERATOR)
 		{	// 为数字或符号，直接输出
 			rp[++p] = tok2unit(tok);
+			seus_check_emit(chk, rp, p, q);
 		} else if (tok.sub_type & 0x40)
 		{	// 为左括号，符号输出并入栈
 			rp[++p] = rp[--q] = tok2unit(tok);
@@ -285,6 +484,7 @@ unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
 					rp[p].type = rp[q].type |= OP_ARG_S;
 				}
 			}
+			seus_check_emit(chk, rp, p, q);
 		} else if (tok.sub_type & 0x80)
 		{	// 为右括号，出栈所有符号直到匹配左括号
 			token_t tok3  = { 0 };
@@ -308,6 +508,7 @@ unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
 					{
 						rp[p] = tok2unit(tok3);
 					}
+					seus_check_emit(chk, rp, p, q);
 					break;
 				} else if (tok2.sub_type & 0x40)
 				{	// 为其他的左括号，括号交叉，为非法表达式，终止解析
@@ -320,6 +521,7 @@ unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
 					{
 						rp[p] = tok2unit(tok2);
 					}
+					seus_check_emit(chk, rp, p, q);
 				}
 				if (q == size)
 				{	// 左括号不存在，为非法表达式，终止解析
@@ -348,6 +550,7 @@ unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
 				{
 					rp[p] = tok2unit(tok2);
 				}
+				seus_check_emit(chk, rp, p, q);
 			} else if (priority == priority2 && get_associativity(tok2.sub_type))
 			{	// 同等优先级按结合性出栈
 				// 结合性为自左向右，操作符出栈输出
@@ -355,6 +558,7 @@ unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
 				{
 					rp[p] = tok2unit(tok2);
 				}
+				seus_check_emit(chk, rp, p, q);
 			} else
 			{	// 其余情况符号入栈
 				rp[--q] = tok2unit(tok);
@@ -378,9 +582,165 @@ unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
 			{
 				rp[p] = tok2unit(tok);
 			}
+			seus_check_emit(chk, rp, p, q);
+		}
+	}
+
+	return p >= q;
+}
+
+// 统计逻辑与、逻辑或的个数，即需要插入的短路单元数的上限
+static int seus_count_logic(const unit_t *units, int n)
+{
+	int count = 0, i = 0;
+	for (; i < n; ++i)
+	{
+		if (SE_UNIT_TYPE(units[i]) == T_OPERATOR
+			&& (SE_UNIT_SUBTYPE(units[i]) == OP_LAND || SE_UNIT_SUBTYPE(units[i]) == OP_LOR))
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+// 为逻辑与、逻辑或插入短路单元，units须能容纳n + seus_count_logic(units, n)个单元
+// 短路单元位于右操作数之前，idx为左操作数决定结果时需要跳过的单元数（至运算符本身）
+// 右操作数的顶层含有数组解构时，其并入括号域的元素数在执行期才能确定，不插入短路单元
+// 仅用于已通过检查的SEUS，返回插入后的单元数
+static int seus_emit_jumps(unit_t *units, int n)
+{
+	int *start  = (int*)se_alloc(n * sizeof(int)); // 元素帧中各值的起始单元
+	char *exp   = (char*)se_alloc(n);              // 值的计算过程是否在顶层解构数组
+	int *scope  = (int*)se_alloc((n + 1) * 2 * sizeof(int)); // 括号域的起始单元与元素帧深度
+	int *target = (int*)se_alloc(n * sizeof(int)); // 在该单元之前插入短路单元时为运算符位置，否则为-1
+	assert(start != 0L && exp != 0L && scope != 0L && target != 0L);
+
+	int d = 0, ns = 0, nj = 0, i;
+	scope[ns * 2] = -1, scope[ns * 2 + 1] = 0, ++ns;
+
+	for (i = 0; i < n; ++i)
+	{
+		target[i] = -1;
+
+		if (SE_UNIT_TYPE(units[i]) != T_OPERATOR)
+		{
+			start[d] = i, exp[d] = 0, ++d;
+			continue;
+		}
+
+		const int op = SE_UNIT_SUBTYPE(units[i]);
+		switch (op)
+		{
+			case OP_BRE_S:
+			case OP_ARG_S:
+			case OP_IDX_S:
+			case OP_ARR_S:
+			{
+				scope[ns * 2] = i, scope[ns * 2 + 1] = d, ++ns;
+			}
+			break;
+			case OP_BRE:
+			case OP_ARR:
+			{	// 括号内的值与已接受的值在域结束时均已归并
+				--ns;
+				d = scope[ns * 2 + 1];
+				start[d] = scope[ns * 2], exp[d] = 0, ++d;
+			}
+			break;
+			case OP_ARG:
+			case OP_IDX:
+			{	// 结果起始于函数或数组
+				--ns;
+				d = scope[ns * 2 + 1];
+				exp[d - 1] = 0;
+			}
+			break;
+			case OP_CME:
+			{	// 域内最底部的值计入已接受的值
+				const int base = scope[ns * 2 - 1];
+				memmove(start + base, start + base + 1, (d - base - 1) * sizeof(int));
+				memmove(exp + base, exp + base + 1, d - base - 1);
+				--d;
+			}
+			break;
+			case OP_PL:
+			case OP_NL:
+			case OP_LNOT:
+			case OP_NOT:
+			break;
+			case OP_EPA:
+			{
+				exp[d - 1] = 1;
+			}
+			break;
+			default:
+			{	// 二元运算
+				--d;
+				if ((op == OP_LAND || op == OP_LOR) && !exp[d])
+				{
+					target[start[d]] = i;
+					++nj;
+				}
+				exp[d - 1] = exp[d - 1] || exp[d];
+			}
+			break;
+		}
+	}
+
+	if (nj > 0)
+	{	// 自后向前移动单元，短路单元的目标总在其后，先行记录各单元移动后的位置
+		int *pos = start; // 复用为输出位置
+		int w = 0;
+		for (i = 0; i < n; ++i)
+		{
+			w += target[i] >= 0;
+			pos[i] = w++;
+		}
+
+		for (i = n - 1; i >= 0; --i)
+		{
+			units[pos[i]] = units[i];
+			if (target[i] >= 0)
+			{
+				const unit_t *op = &units[pos[target[i]]];
+				unit_t *jump = &units[pos[i] - 1];
+				*jump = *op;
+				jump->type = (uint16_t)(T_OPERATOR << 8
+					| (SE_UNIT_SUBTYPE(*op) == OP_LAND ? OP_LAND_JMP : OP_LOR_JMP));
+				jump->idx = (uint16_t)(pos[target[i]] - (pos[i] - 1));
+			}
 		}
 	}
 
+	se_free(start);
+	se_free(exp);
+	se_free(scope);
+	se_free(target);
+
+	return n + nj;
+}
+
+// 将TOKENS转换为逆波兰表达式
+unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
+{
+	assert(psize != 0L);
+
+	if (tokens == 0L || ntok <= 0)
+	{
+		se_throw(UnknownError, ArgumentErrorInCSrc, 0, 0);
+		*psize = 0;
+		return 0L;
+	}
+
+	se_exception_t last_exception = { 0 };
+	se_catch_any(&last_exception);
+
+	unit_t *rp = se_alloc(ntok * sizeof(unit_t));
+	assert(rp != 0L);
+
+	toks_shunt(tokens, ntok, rp, 0L);
+
 	if (!se_caught())
 	{
 		se_free(rp);
@@ -388,7 +748,7 @@ unit_t *toks2rpn(token_t *tokens, int ntok, int *psize)
 		*psize = 0;
 	} else
 	{
-		*psize = size;
+		*psize = ntok;
 		se_throw(last_exception.etype, last_exception.error,
 			last_exception.extra, last_exception.reserved);
 	}
@@ -410,195 +770,54 @@ seus_t rpn2seus(unit_t *units, int n)
 		goto _complete;
 	}
 
-	int ef = -1, nef = ef; // 入栈的元素帧 element frame
-	int vf = -1, nvf = vf; // 弹出元素的值帧 moved value frame
-
 	scopestate_t *ss; // 括号域状态
-	int p = -1, nss = 1;
+	int nss = 1;
 
 	int i = 0;
 	do {
 		if ((units[i].type >> 8 & 0xf) == T_OPERATOR)
 		switch (units[i].type & 0xff)
-		{
-			case OP_BRE:
-			case OP_ARG:
-			case OP_IDX:
-			case OP_ARR: ++nss;
+		{	// 按左括号计数，未闭合的括号同样会压入括号域
+			case OP_BRE_S:
+			case OP_ARG_S:
+			case OP_IDX_S:
+			case OP_ARR_S: ++nss;
 		}
 	} while (++i < n);
 
 	ss = (scopestate_t*)se_alloc(nss * sizeof(scopestate_t));
 	assert(ss != 0L);
 
-	ss[++p] = (scopestate_t){ ef + 1, 0 };
-	nss = 1; // 用于确定ss的真实最大长度	
+	seuscheck_t chk;
+	seus_check_init(&chk, ss);
 
 	for (i = 0; i < n; ++i)
 	{
-		unit_t *e = units + i;
-		if ((e->type >> 8 & 0xf) == T_OPERATOR)
-		switch (e->type & 0xff)
+		if (seus_check_step(&chk, units + i, i) != 0)
 		{
-			case OP_BRE_S:
-			case OP_ARG_S:
-			case OP_IDX_S:
-			case OP_ARR_S:
-			{	// 压入新的括号域
-				ss[++p] = (scopestate_t){ ef + 1, 0 };
-				if (p >= nss)
-				{
-					nss = p + 1;
-				}
-			}
-			continue;
-			case OP_BRE:
-			case OP_ARG:
-			case OP_IDX:
-			case OP_ARR:
-			{
-				int nele;
-
-				if (ef > ss[p].sframe)
-				{
-					se_throw(SyntaxError, MissingComma, i, 0);
-					goto _error;
-				} else if (ef < ss[p].sframe)
-				{
-					if (ss[p].accept > 0)
-					{
-						se_throw(SyntaxError, TooManyCommas, i, 0);
-						goto _error;
-					} else
-					{
-						nele = 0;
-					}
-				} else if (ss[p].accept > 0)
-				{
-					nele = ss[p].accept + 1;
-				} else
-				{
-					nele = 1;
-				}
-
-				int op = e->type & 0xff;
-
-				if (nele == 0)
-				{
-					if (op == OP_IDX)
-					{
-						se_throw(IndexError, NoIndex, i, 0);
-						goto _error;
-					} else
-					{
-						++ef;
-						if (ef > nef)
-						{
-							nef = ef;
-						}
-					}
-				} else
-				{
-					vf -= ss[p].accept;
-					if (vf < -1)
-					{
-						se_throw(SyntaxError, InvalidSyntax, i, 0);
-						goto _error;
-					}
-				}
-
-				if (op == OP_IDX)
-				{
-					--ef;
-					if (ef < 0)
-					{
-						se_throw(IndexError, MissingArray, i, 0);
-						goto _error;
-					}
-				}
-
-				if (op == OP_ARG)
-				{
-					--ef;
-					if (ef < 0)
-					{
-						se_throw(RuntimeError, ExpectFunction, i, 0);
-						goto _error;
-					}
-				}
-
-				--p;
-
-				if (p < 0)
-				{
-					se_throw(SyntaxError, InvalidSyntax, i, 0);
-					goto _error;
-				}
-			}
-			continue;
-			case OP_CME:
-			{
-				if (ef >= ss[p].sframe)
-				{
-					++ss[p].accept;
-					--ef;
-					++vf;
-					if (vf > nvf)
-					{
-						nvf = vf;
-					}
-				} else
-				{
-					se_throw(SyntaxError, TooManyCommas, i, 0);
-					goto _error;
-				}
-			}
-			continue;
-			case OP_PL:
-			case OP_NL:
-			case OP_EPA: // uncertain
-			case OP_NOT:
-			case OP_LNOT:
-			{
-				if (ef < ss[p].sframe)
-				{
-					se_throw(SyntaxError, MissingOperand, i, 0);
-					goto _error;
-				}
-			}
-			continue;
-			default:
-			{
-				--ef;
-				if (ef < ss[p].sframe)
-				{
-					se_throw(SyntaxError, MissingOperand, i, 0);
-					goto _error;
-				}
-			}
-			continue;
-		}
-
-		++ef;
-		if (ef > nef)
-		{
-			nef = ef;
+			goto _error;
 		}
 	}
 
-	if (ef != 0)
+	if (seus_check_done(&chk, n) != 0)
 	{
-		se_throw(SyntaxError, InvalidSyntax, n, ef);
 		goto _error;
 	}
 
 _done:
+	if (seus_count_logic(units, n) > 0)
+	{
+		units = (unit_t*)se_realloc(units, (n + seus_count_logic(units, n)) * sizeof(unit_t));
+		assert(units != 0L);
+		n = seus_emit_jumps(units, n);
+	}
+
 	seus = (seus_t){
-		.nef = nef > 0 ? nef : 0,
-		.nvf = nvf > 0 ? nvf : 0,
-		.nss = nss,
+		.nef = chk.nef > 0 ? chk.nef : 0,
+		.nvf = chk.nvf > 0 ? chk.nvf : 0,
+		.nss = chk.nss,
 		.nus = n,
-		.ss  = (scopestate_t*)se_alloc(nss * sizeof(scopestate_t)),
+		.ss  = (scopestate_t*)se_alloc(chk.nss * sizeof(scopestate_t)),
 		.us  = units,
 	};
 	assert(seus.ss != 0L);
@@ -622,6 +841,96 @@ _complete:
 	return seus;
 }
 
+// 单趟编译，调度场算法每输出一个单元即模拟其执行，直接得到SEUS
+// seus中已有的us与ss作为缓冲区复用，容量不足时重新申请
+int toks2seus(const token_t *tokens, int ntok, seus_t *seus)
+{
+	assert(seus != 0L);
+
+	if (tokens == 0L || ntok <= 0)
+	{
+		se_throw(UnknownError, ArgumentErrorInCSrc, 0, 0);
+		return 1;
+	}
+
+	se_exception_t last_exception = { 0 };
+	se_catch_any(&last_exception);
+
+	int nlogic = 0, i = 0;
+	for (; i < ntok; ++i)
+	{
+		if (tokens[i].type == T_OPERATOR
+			&& (tokens[i].sub_type == OP_LAND || tokens[i].sub_type == OP_LOR))
+		{
+			++nlogic;
+		}
+	}
+
+	// 逆波兰表达式与符号栈共用us，另为短路单元预留空间，括号域不超过左括号数加一
+	if (seus->us == 0L || se_msize(seus->us) < (ntok + nlogic) * sizeof(unit_t))
+	{
+		if (seus->us != 0L) se_free(seus->us);
+		seus->us = (unit_t*)se_alloc((ntok + nlogic) * sizeof(unit_t));
+		assert(seus->us != 0L);
+	}
+
+	if (seus->ss == 0L || se_msize(seus->ss) < (ntok + 1) * sizeof(scopestate_t))
+	{
+		if (seus->ss != 0L) se_free(seus->ss);
+		seus->ss = (scopestate_t*)se_alloc((ntok + 1) * sizeof(scopestate_t));
+		assert(seus->ss != 0L);
+	}
+
+	seus->nef = seus->nvf = seus->nss = seus->nus = seus->ncs = 0;
+	seus->symgen = 0;
+	seus->fusegen = 0;
+
+	if (seus->rvm != 0L)
+	{	// 寄存器指令引用旧的单元
+		se_free(seus->rvm);
+		seus->rvm = 0L;
+	}
+
+	seuscheck_t chk;
+	seus_check_init(&chk, seus->ss);
+
+	int overlap = toks_shunt(tokens, ntok, seus->us, &chk);
+
+	if (se_caught() && overlap)
+	{	// 输出与符号栈重叠后的单元未经检查，按最终的单元重新检查
+		seus_check_init(&chk, seus->ss);
+
+		for (i = 0; i < ntok; ++i)
+		{
+			if (seus_check_step(&chk, seus->us + i, i) != 0) break;
+		}
+	} else if (se_caught() && chk.failed)
+	{
+		se_throw(chk.error.etype, chk.error.error,
+			chk.error.extra, chk.error.reserved);
+	}
+
+	if (se_caught())
+	{
+		seus_check_done(&chk, ntok);
+	}
+
+	if (!se_caught())
+	{
+		return 1;
+	}
+
+	seus->nef = chk.nef > 0 ? chk.nef : 0;
+	seus->nvf = chk.nvf > 0 ? chk.nvf : 0;
+	seus->nss = chk.nss;
+	seus->nus = nlogic > 0 ? seus_emit_jumps(seus->us, ntok) : ntok;
+
+	se_throw(last_exception.etype, last_exception.error,
+		last_exception.extra, last_exception.reserved);
+
+	return 0;
+}
+
 void free_seus(seus_t *seus)
 {
 	if (seus != 0L)
@@ -634,6 +943,14 @@ void free_seus(seus_t *seus)
 		{
 			se_free(seus->ss);
 		}
+		if (seus->cs != 0L)
+		{
+			se_free(seus->cs);
+		}
+		if (seus->rvm != 0L)
+		{
+			se_free(seus->rvm);
+		}
 		memset(seus, 0, sizeof(seus_t));
 	}
 }
\ No newline at end of file
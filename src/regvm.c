@@ -0,0 +1,349 @@
+#ifndef SE_CONTEXT_BUILD
+#error regvm.c is only available in context.c
+#endif
+
+// 寄存器虚拟机：SEUS编译为以寄存器编号寻址的指令，不经过元素帧栈
+// 寄存器按编译期的栈深度分配，逗号不再移动值，括号域内的值占据连续的寄存器窗口，
+// 函数参数与数组元素直接以窗口传递；运算语义与栈动作共用action.c中的实现
+
+// 寄存器指令
+typedef struct reginst_s
+{
+	uint16_t op;  // 动作编号（SE_ACT_*）
+	uint16_t sub; // 运算符子类型
+	uint16_t a;   // 目标寄存器，同时为首个操作数或窗口之前的寄存器
+	uint16_t b;   // 第二个操作数寄存器、窗口长度或短路时跳转到的指令
+	unit_t *unit; // 符号与数字指令的源单元
+} reginst_t;
+
+// seus_t.rvm 结构，指令紧随其后
+typedef struct regcode_s
+{
+	int ninst;  // 指令数（为负时语句无法编译为寄存器指令，由栈动作执行）
+	int nregs;  // 寄存器数
+	int result; // 结果所在的寄存器
+	reginst_t *inst;
+///-------- native tier (jit.c) --------
+	uint32_t hits;   // 以SE_EXEC_JIT执行但尚未编译为本机代码的次数
+	int ndeopt;      // 编译失败或类型推测失败的次数
+	int tier;        // 为负时不再尝试编译本机代码
+	const void *jit; // 已编译的本机代码（jitcode_t）
+} regcode_t;
+
+// 编译期的括号域
+typedef struct regscope_s
+{
+	int base;  // 域内首个寄存器
+	int moved; // 已被逗号移出元素帧的值数（位于窗口底部）
+} regscope_t;
+
+// 编译期尚未到达目标的短路指令
+typedef struct regjump_s
+{
+	int target; // 目标单元（运算符）的位置
+	int inst;   // 短路指令的位置
+} regjump_t;
+
+// 将SEUS编译为寄存器指令
+// 指令数无法在编译期确定（数组解构）或元素帧的用法与栈动作不一致时返回ninst为-1的结果
+static regcode_t* se_rvm_compile(seus_t *seus)
+{
+	regcode_t *code = (regcode_t*)se_alloc(sizeof(regcode_t) + seus->nus * sizeof(reginst_t));
+	regscope_t *scopes = (regscope_t*)se_alloc((seus->nus + 1) * sizeof(regscope_t));
+	regjump_t *jumps = (regjump_t*)se_alloc(seus->nus * sizeof(regjump_t));
+	if (code == 0L || scopes == 0L || jumps == 0L)
+	{
+		if (code != 0L) se_free(code);
+		if (scopes != 0L) se_free(scopes);
+		if (jumps != 0L) se_free(jumps);
+		return 0L;
+	}
+
+	reginst_t *inst = (reginst_t*)(code + 1);
+	int depth = 0, nregs = 0, n = 0, nscope = 0, njump = 0, ok = 1;
+
+	scopes[nscope++] = (regscope_t){ 0, 0 }; // 语句本身的域
+
+	int i = 0;
+	for (; i < seus->nus && ok; ++i)
+	{
+		unit_t *unit = &seus->us[i];
+		const int act = se_ctx_base_action(unit); // 栈动作执行过的SEUS可能已融合
+		regscope_t *scope = &scopes[nscope - 1];
+		const int nef = depth - scope->base - scope->moved; // 域内元素帧的值数
+
+		switch (act)
+		{
+			case SE_ACT_JUMP:
+			{	// 左操作数决定结果时跳至运算符之后的指令，位置在到达运算符后回填
+				ok = nef >= 1;
+				jumps[njump++] = (regjump_t){ i + unit->idx, n };
+				inst[n++] = (reginst_t){ act, SE_UNIT_SUBTYPE(*unit),
+					(uint16_t)(depth - 1), 0, 0L };
+			}
+			break;
+			case SE_ACT_SYMBOL:
+			case SE_ACT_NUMBER:
+			{
+				inst[n++] = (reginst_t){ act, 0, (uint16_t)depth, 0, unit };
+				if (++depth > nregs)
+				{
+					nregs = depth;
+				}
+			}
+			break;
+			case SE_ACT_SCOPE:
+			{
+				scopes[nscope++] = (regscope_t){ depth, 0 };
+			}
+			break;
+			case SE_ACT_COMMA:
+			{	// 值留在原寄存器，仅记入窗口
+				ok = nef >= 1;
+				++scope->moved;
+			}
+			break;
+			case SE_ACT_SIGN:
+			case SE_ACT_LNOT:
+			case SE_ACT_NOT:
+			{
+				ok = nef >= 1;
+				inst[n++] = (reginst_t){ act, SE_UNIT_SUBTYPE(*unit),
+					(uint16_t)(depth - 1), (uint16_t)(depth - 1), 0L };
+			}
+			break;
+			case SE_ACT_ASSIGN:
+			case SE_ACT_BASECALC:
+			case SE_ACT_COMPARE:
+			case SE_ACT_BITOP:
+			case SE_ACT_CALC_ASS:
+			{
+				ok = nef >= 2;
+				inst[n++] = (reginst_t){ act, SE_UNIT_SUBTYPE(*unit),
+					(uint16_t)(depth - 2), (uint16_t)(depth - 1), 0L };
+				--depth;
+			}
+			break;
+			case SE_ACT_BRACKET:
+			case SE_ACT_FNCALL:
+			case SE_ACT_INDEX:
+			case SE_ACT_MAKEARRAY:
+			{	// 窗口为[base, depth)，元素帧须恰好剩余最后一个值（空域时窗口为空）
+				const int base = scope->base;
+				const int len  = depth - base;
+				ok = nscope > 1 && (nef == 1 || len == 0);
+				if (!ok) break;
+
+				--nscope;
+				scope = &scopes[nscope - 1];
+
+				if (act == SE_ACT_FNCALL || act == SE_ACT_INDEX)
+				{	// 函数或数组位于窗口之前的寄存器
+					ok = base - scope->base - scope->moved >= 1;
+					if (act == SE_ACT_INDEX)
+					{
+						ok = ok && len > 0;
+						inst[n++] = (reginst_t){ act, 0,
+							(uint16_t)(base - 1), (uint16_t)(depth - 1), 0L };
+					} else
+					{
+						inst[n++] = (reginst_t){ act, 0,
+							(uint16_t)(base - 1), (uint16_t)len, 0L };
+					}
+					depth = base;
+				} else
+				{
+					if (len == 0 && base + 1 > nregs)
+					{
+						nregs = base + 1;
+					}
+					if (act == SE_ACT_MAKEARRAY || len != 1)
+					{	// 只包含一个值的括号无需指令
+						inst[n++] = (reginst_t){ act, 0,
+							(uint16_t)base, (uint16_t)len, 0L };
+					}
+					depth = base + 1;
+				}
+			}
+			break;
+			default:
+			{	// 数组解构的元素数在执行期才能确定
+				ok = 0;
+			}
+			break;
+		}
+
+		while (njump > 0 && jumps[njump - 1].target == i)
+		{
+			inst[jumps[--njump].inst].b = (uint16_t)n;
+		}
+	}
+
+	ok = ok && nscope == 1 && njump == 0 && depth - scopes[0].moved >= 1;
+
+	code->ninst  = ok ? n : -1;
+	code->nregs  = nregs;
+	code->result = depth - 1;
+	code->inst   = inst;
+	code->hits   = 0;
+	code->ndeopt = 0;
+	code->tier   = 0;
+	code->jit    = 0L;
+
+	se_free(scopes);
+	se_free(jumps);
+
+	return code;
+}
+
+// 预留寄存器
+static int se_rvm_reserve(ctxmemory_t *ctxmem, int nregs)
+{
+	if (nregs <= ctxmem->nregs)
+	{
+		return 0;
+	}
+
+	int capacity = ctxmem->nregs > 0 ? ctxmem->nregs : 16;
+	while (capacity < nregs)
+	{
+		capacity <<= 1;
+	}
+
+	se_object_t *regs = (se_object_t*)se_alloc(capacity * sizeof(se_object_t));
+	if (regs == 0L)
+	{
+		se_throw(RuntimeError, BadAlloc, capacity * sizeof(se_object_t), 0);
+		return 1;
+	}
+
+	if (ctxmem->regs != 0L)
+	{
+		se_free(ctxmem->regs);
+	}
+	ctxmem->regs  = regs;
+	ctxmem->nregs = capacity;
+
+	return 0;
+}
+
+// 取SEUS的寄存器指令，首次执行时编译；无法编译时返回0L，由栈动作执行
+static regcode_t* se_rvm_prepare(seus_t *seus)
+{
+	if (seus->rvm == 0L)
+	{
+		seus->rvm = se_rvm_compile(seus);
+		if (seus->rvm == 0L)
+		{
+			return 0L;
+		}
+	}
+
+	regcode_t *code = (regcode_t*)seus->rvm;
+	if (code->ninst < 0)
+	{
+		return 0L;
+	}
+
+	return code;
+}
+
+// 执行寄存器指令，成功时结果存入out
+static int se_rvm_exec(se_context_t *ctx, const regcode_t *code, se_object_t *out)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (se_rvm_reserve(ctxmem, code->nregs) != 0)
+	{
+		return 1;
+	}
+
+	se_object_t *r = ctxmem->regs;
+
+	const reginst_t *in = code->inst, *end = code->inst + code->ninst;
+	for (; in != end; ++in)
+	{
+		se_object_t *x = &r[in->a];
+
+		int state = 0;
+		switch (in->op)
+		{
+			case SE_ACT_SYMBOL: state = se_ctx_load_symbol(ctx, in->unit, x); break;
+			case SE_ACT_NUMBER: state = se_ctx_load_number(ctx, in->unit, x); break;
+			case SE_ACT_BRACKET:
+			{	// 取窗口中的最后一个值，其余的值生命周期结束
+				if (in->b == 0)
+				{
+					*x = wrap2obj(0L, EO_NIL);
+					break;
+				}
+				int c = 0;
+				for (; c < in->b - 1; ++c)
+				{
+					se_ctx_mov2blc(ctx, &x[c]);
+				}
+				*x = x[in->b - 1];
+			}
+			break;
+			case SE_ACT_FNCALL:
+			{	// 参数为紧随函数之后的窗口
+				state = se_ctx_call(ctx, *x, in->b > 0 ? x + 1 : 0L, in->b, x);
+			}
+			break;
+			case SE_ACT_INDEX:  state = se_ctx_index(ctx, *x, r[in->b], x); break;
+			case SE_ACT_MAKEARRAY:
+			{
+				se_array_t as = { 0 };
+				if (in->b > 0)
+				{
+					as.size = in->b;
+					as.data = (se_object_t*)se_ctx_reqtmp(ctx,
+						as.size * sizeof(se_object_t), TMP_ELEMENTS, as.size);
+					if (as.data == 0L)
+					{
+						se_throw(RuntimeError, BadAlloc, as.size * sizeof(se_object_t), 0);
+						return 1;
+					}
+					memcpy(as.data, x, as.size * sizeof(se_object_t));
+				}
+				state = se_ctx_make_array(ctx, as, x);
+			}
+			break;
+			case SE_ACT_ASSIGN:   state = se_ctx_assign(ctx, *x, r[in->b], x); break;
+			case SE_ACT_CALC_ASS: state = se_ctx_calc_assign(ctx, in->sub, *x, r[in->b], x); break;
+			case SE_ACT_SIGN:
+			case SE_ACT_LNOT:
+			case SE_ACT_NOT:
+			{
+				state = se_ctx_calc_unary(ctx, in->op, in->sub, *x, x);
+			}
+			break;
+			case SE_ACT_BASECALC:
+			case SE_ACT_COMPARE:
+			case SE_ACT_BITOP:
+			{
+				state = se_ctx_calc_binary(ctx, in->op, in->sub, *x, r[in->b], x);
+			}
+			break;
+			case SE_ACT_JUMP:
+			{
+				int decided;
+				state = se_ctx_decide(ctx, in->sub, *x, x, &decided);
+				if (state == 0 && decided)
+				{
+					in = code->inst + in->b - 1;
+				}
+			}
+			break;
+		}
+
+		if (state != 0)
+		{
+			return 1;
+		}
+	}
+
+	*out = r[code->result];
+
+	return 0;
+}
@@ -0,0 +1,310 @@
+#ifndef SE_CONTEXT_BUILD
+#error script.c is only available in context.c
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define SE_SCRIPT_MAX_THREADS 64 // 并行编译的最大线程数
+
+// 单个语句的编译任务
+typedef struct stmtjob_s
+{
+	const char *begin;    // 语句起始位置（以';'或'\0'结束）
+	seus_t seus;          // 编译结果（由系统分配器申请）
+	se_exception_t error; // 编译异常（etype为0时编译成功）
+} stmtjob_t;
+
+typedef struct scriptwork_s
+{
+	stmtjob_t *jobs;
+	long njobs;
+	se_atomic_t next; // 下一个待领取的任务
+} scriptwork_t;
+
+// 编译一个语句，异常记录在任务中
+static void se_script_compile_one(stmtjob_t *job)
+{
+	token_t *tokens = 0L;
+	int ntokens = 0;
+
+	str2tokens(job->begin, &tokens, &ntokens);
+
+	if (se_caught() && ntokens > 0)
+	{
+		if (toks2seus(tokens, ntokens, &job->seus) == 0)
+		{
+			se_ctx_link(&job->seus);
+			se_ctx_fold(&job->seus);
+		}
+	}
+
+	se_catch_any(&job->error);
+
+	if (tokens != 0L)
+	{
+		se_free(tokens);
+	}
+}
+
+// 领取并编译任务直至全部领完
+// 语句编译不依赖环境状态，使用系统分配器，结果由调用线程复制进环境
+static void se_script_work(scriptwork_t *work)
+{
+	int old_mempool_id = se_current_allocator();
+	se_allocator_restore();
+
+	long i;
+	while ((i = se_atomic_inc(&work->next) - 1) < work->njobs)
+	{
+		se_script_compile_one(&work->jobs[i]);
+	}
+
+	se_allocator_set(old_mempool_id);
+}
+
+#if defined(_WIN32)
+typedef HANDLE se_thread_t;
+
+static DWORD WINAPI se_script_thread(LPVOID arg)
+{
+	se_script_work((scriptwork_t*)arg);
+	return 0;
+}
+
+static int se_script_spawn(se_thread_t *thread, scriptwork_t *work)
+{
+	*thread = CreateThread(0L, 0, se_script_thread, work, 0, 0L);
+	return *thread == 0L;
+}
+
+static void se_script_join(se_thread_t thread)
+{
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+static int se_script_ncpu()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t se_thread_t;
+
+static void* se_script_thread(void *arg)
+{
+	se_script_work((scriptwork_t*)arg);
+	return 0L;
+}
+
+static int se_script_spawn(se_thread_t *thread, scriptwork_t *work)
+{
+	return pthread_create(thread, 0L, se_script_thread, work);
+}
+
+static void se_script_join(se_thread_t thread)
+{
+	pthread_join(thread, 0L);
+}
+
+static int se_script_ncpu()
+{
+	return (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
+#endif
+
+// 复制工作线程的编译结果到环境的内存池
+static int se_script_adopt(se_program_t *prog, const seus_t *seus)
+{
+	memset(prog, 0, sizeof(se_program_t));
+
+	prog->seus = *seus;
+	prog->seus.us = (unit_t*)se_alloc(seus->nus * sizeof(unit_t));
+	prog->seus.ss = (scopestate_t*)se_alloc(seus->nss * sizeof(scopestate_t));
+	prog->seus.cs = seus->ncs != 0 ? (se_number_t*)se_alloc(seus->ncs * sizeof(se_number_t)) : 0L;
+	if (prog->seus.us == 0L || prog->seus.ss == 0L || (seus->ncs != 0 && prog->seus.cs == 0L))
+	{
+		free_seus(&prog->seus);
+		return 1;
+	}
+
+	memcpy(prog->seus.us, seus->us, seus->nus * sizeof(unit_t));
+	if (seus->ncs != 0)
+	{
+		memcpy(prog->seus.cs, seus->cs, seus->ncs * sizeof(se_number_t));
+	}
+
+	return 0;
+}
+
+int se_ctx_compile_script(se_context_t *ctx, const char *script, int nthreads, se_script_t *out)
+{	// 按';'拆分脚本，各语句并行编译后按顺序交给调用者
+	assert(ctx != 0L);
+	assert(out != 0L);
+
+	memset(out, 0, sizeof(se_script_t));
+
+	if (script == 0L)
+	{
+		return 1;
+	}
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	const size_t len = strlen(script);
+	char *text = (char*)se_alloc(len + 1);
+	assert(text != 0L);
+	memcpy(text, script, len + 1);
+
+	long njobs = 1;
+	const char *p = text;
+	while ((p = strchr(p, ';')) != 0L)
+	{
+		++njobs;
+		++p;
+	}
+
+	stmtjob_t *jobs = (stmtjob_t*)se_alloc(njobs * sizeof(stmtjob_t));
+	assert(jobs != 0L);
+	memset(jobs, 0, njobs * sizeof(stmtjob_t));
+
+	long i = 0;
+	for (p = text; i < njobs; ++i)
+	{
+		jobs[i].begin = p;
+		p = strchr(p, ';');
+		p = p != 0L ? p + 1 : text + len;
+	}
+
+	if (nthreads <= 0)
+	{
+		nthreads = se_script_ncpu();
+	}
+	if (nthreads > njobs) nthreads = (int)njobs;
+	if (nthreads > SE_SCRIPT_MAX_THREADS) nthreads = SE_SCRIPT_MAX_THREADS;
+
+	scriptwork_t work = { jobs, njobs, 0 };
+	se_thread_t threads[SE_SCRIPT_MAX_THREADS];
+
+	// 调用线程同样领取任务，线程创建失败时由其余线程完成
+	int nspawned = 0;
+	while (nspawned < nthreads - 1
+		&& se_script_spawn(&threads[nspawned], &work) == 0)
+	{
+		++nspawned;
+	}
+
+	se_script_work(&work);
+
+	int k = 0;
+	for (; k < nspawned; ++k)
+	{
+		se_script_join(threads[k]);
+	}
+
+	// 与逐句执行一致，报告首个出错语句的异常
+	const se_exception_t *error = 0L;
+	int nprogs = 0;
+	for (i = 0; i < njobs; ++i)
+	{
+		if (jobs[i].error.etype != 0)
+		{
+			error = &jobs[i].error;
+			break;
+		}
+		if (jobs[i].seus.nus != 0)
+		{
+			++nprogs;
+		}
+	}
+
+	int state = error != 0L;
+	if (state == 0 && nprogs > 0)
+	{
+		out->progs = (se_program_t*)se_alloc(nprogs * sizeof(se_program_t));
+		assert(out->progs != 0L);
+
+		for (i = 0; i < njobs && state == 0; ++i)
+		{
+			if (jobs[i].seus.nus == 0) continue;
+			state = se_script_adopt(&out->progs[out->nprogs], &jobs[i].seus);
+			if (state == 0)
+			{
+				++out->nprogs;
+			} else
+			{
+				se_throw(RuntimeError, BadAlloc, jobs[i].seus.nus * sizeof(unit_t), 0);
+			}
+		}
+	}
+
+	if (error != 0L)
+	{
+		se_throw(error->etype, error->error, error->extra, error->reserved);
+	}
+
+	// 工作线程的编译结果由系统分配器申请
+	se_allocator_restore();
+	for (i = 0; i < njobs; ++i)
+	{
+		free_seus(&jobs[i].seus);
+	}
+	se_allocator_set(ctxmem->mempool_id);
+
+	se_free(jobs);
+
+	out->text = text;
+	if (state != 0)
+	{
+		se_ctx_discard_script(ctx, out);
+	}
+
+	se_allocator_set(old_mempool_id);
+
+	return state;
+}
+
+int se_ctx_discard_script(se_context_t *ctx, se_script_t *script)
+{
+	assert(ctx != 0L);
+
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	assert(ctxmem != 0L);
+
+	if (script == 0L) return 1;
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	int i = 0;
+	for (; i < script->nprogs; ++i)
+	{
+		free_seus(&script->progs[i].seus);
+	}
+
+	if (script->progs != 0L)
+	{
+		se_free(script->progs);
+	}
+
+	if (script->text != 0L)
+	{
+		se_free(script->text);
+	}
+
+	memset(script, 0, sizeof(se_script_t));
+
+	se_allocator_set(old_mempool_id);
+
+	return 0;
+}
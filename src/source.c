@@ -0,0 +1,312 @@
+#ifndef SE_CONTEXT_BUILD
+#error source.c is only available in context.c
+#endif
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+
+#define SE_SOURCE_BLOCK 4096 // 读取回调每次请求的字节数
+
+// 申请可容纳len字节源码的分块（须在环境的内存分配器下调用）
+static srcchunk_t* se_ctx_source_chunk(size_t len)
+{
+	srcchunk_t *chunk = (srcchunk_t*)se_alloc(sizeof(srcchunk_t) + len + 1);
+	if (chunk == 0L)
+	{
+		return 0L;
+	}
+
+	chunk->next = 0L;
+	chunk->text = (char*)(chunk + 1);
+	chunk->len  = 0;
+	chunk->mapped = 0;
+	chunk->text[0] = '\0';
+
+	return chunk;
+}
+
+// 映射文件为分块，文件之后附加一个清零的匿名页作为'\0'结尾
+// 文件为空、不是普通文件或平台不支持映射时返回0L
+static srcchunk_t* se_ctx_source_map(const char *path)
+{
+#if defined(_WIN32)
+	(void)path;
+	return 0L;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return 0L;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+	{
+		close(fd);
+		return 0L;
+	}
+
+	const size_t len = (size_t)st.st_size;
+	const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	const size_t mapped = (len / page + 1) * page;
+
+	char *text = (char*)mmap(0L, mapped, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (text == MAP_FAILED)
+	{
+		close(fd);
+		return 0L;
+	}
+
+	if (mmap(text, len, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+	{
+		munmap(text, mapped);
+		close(fd);
+		return 0L;
+	}
+
+	close(fd);
+	madvise(text, len, MADV_SEQUENTIAL);
+
+	srcchunk_t *chunk = (srcchunk_t*)se_alloc(sizeof(srcchunk_t));
+	if (chunk == 0L)
+	{
+		munmap(text, mapped);
+		return 0L;
+	}
+
+	chunk->next   = 0L;
+	chunk->text   = text;
+	chunk->len    = len;
+	chunk->mapped = mapped;
+
+	return chunk;
+#endif
+}
+
+// 将文件完整读入分块，用于无法映射的文件
+static srcchunk_t* se_ctx_source_read(const char *path)
+{
+	FILE *fp = fopen(path, "rb");
+	if (fp == 0L)
+	{
+		return 0L;
+	}
+
+	size_t capacity = SE_SOURCE_BLOCK;
+	srcchunk_t *chunk = se_ctx_source_chunk(capacity);
+	assert(chunk != 0L);
+
+	size_t n;
+	while ((n = fread(chunk->text + chunk->len, 1, capacity - chunk->len, fp)) > 0)
+	{
+		chunk->len += n;
+		if (chunk->len == capacity)
+		{
+			capacity <<= 1;
+			chunk = (srcchunk_t*)se_realloc(chunk, sizeof(srcchunk_t) + capacity + 1);
+			assert(chunk != 0L);
+			chunk->text = (char*)(chunk + 1);
+		}
+	}
+
+	fclose(fp);
+	chunk->text[chunk->len] = '\0';
+
+	return chunk;
+}
+
+// 解除分块的文件映射（分块本身由调用者释放）
+static void se_ctx_source_unmap(srcchunk_t *chunk)
+{
+#if !defined(_WIN32)
+	if (chunk->mapped != 0)
+	{
+		munmap(chunk->text, chunk->mapped);
+		chunk->mapped = 0;
+	}
+#endif
+}
+
+// 分块加入队列末尾，队列为空时直接作为正在读取的分块
+static void se_ctx_source_push(se_context_t *ctx, srcchunk_t *chunk)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (ctxmem->src_tail == 0L)
+	{
+		ctxmem->src_head = chunk;
+		ctxmem->src_tail = chunk;
+		ctx->next_statement = chunk->text;
+	} else
+	{
+		ctxmem->src_tail->next = chunk;
+		ctxmem->src_tail = chunk;
+	}
+}
+
+// 载入的代码按载入顺序执行：读取回调尚未读完时，分块暂存至回调读完之后
+static void se_ctx_source_append(se_context_t *ctx, srcchunk_t *chunk)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	if (ctxmem->reader == 0L)
+	{
+		se_ctx_source_push(ctx, chunk);
+		return;
+	}
+
+	if (ctxmem->src_later_tail == 0L)
+	{
+		ctxmem->src_later = chunk;
+	} else
+	{
+		ctxmem->src_later_tail->next = chunk;
+	}
+	ctxmem->src_later_tail = chunk;
+}
+
+// 将读取回调中尚未完整的代码作为分块加入队列，随后接上回调期间载入的分块
+static void se_ctx_source_flush(se_context_t *ctx)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+	srcchunk_t *pending = ctxmem->src_pending;
+
+	ctxmem->src_pending  = 0L;
+	ctxmem->src_capacity = 0;
+	ctxmem->reader       = 0L;
+	ctxmem->reader_data  = 0L;
+
+	if (pending != 0L && pending->len == 0)
+	{
+		se_free(pending);
+	} else if (pending != 0L)
+	{
+		se_ctx_source_push(ctx, pending);
+	}
+
+	srcchunk_t *later = ctxmem->src_later;
+	ctxmem->src_later = ctxmem->src_later_tail = 0L;
+	while (later != 0L)
+	{
+		srcchunk_t *next = later->next;
+		later->next = 0L;
+		se_ctx_source_push(ctx, later);
+		later = next;
+	}
+}
+
+// 从读取回调中读取至少一个完整语句组成的分块，分块在最后一个';'之后截断
+// 截断后的剩余部分留待下次读取，成功加入分块返回1，读取结束返回0
+static int se_ctx_source_pull(se_context_t *ctx)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	while (ctxmem->reader != 0L)
+	{
+		srcchunk_t *pending = ctxmem->src_pending;
+
+		if (pending == 0L || ctxmem->src_capacity - pending->len < SE_SOURCE_BLOCK)
+		{
+			size_t capacity = SE_SOURCE_BLOCK;
+			if (pending == 0L)
+			{
+				pending = se_ctx_source_chunk(capacity);
+			} else
+			{	// 单个语句超过容量，倍增后继续读取
+				capacity = ctxmem->src_capacity << 1;
+				pending = (srcchunk_t*)se_realloc(pending, sizeof(srcchunk_t) + capacity + 1);
+			}
+			assert(pending != 0L);
+			pending->text = (char*)(pending + 1);
+			ctxmem->src_pending  = pending;
+			ctxmem->src_capacity = capacity;
+		}
+
+		char *buffer = pending->text + pending->len;
+		size_t n = ctxmem->reader(ctxmem->reader_data, buffer, SE_SOURCE_BLOCK);
+		if (n == 0)
+		{	// 读取结束，剩余部分自成分块
+			se_ctx_source_flush(ctx);
+			return ctxmem->src_tail != 0L;
+		}
+
+		assert(n <= SE_SOURCE_BLOCK);
+
+		// 语句只在新读入的部分中结束
+		size_t end = n;
+		while (end > 0 && buffer[end - 1] != ';')
+		{
+			--end;
+		}
+
+		pending->len += n;
+		pending->text[pending->len] = '\0';
+
+		if (end == 0)
+		{
+			continue;
+		}
+
+		// 剩余部分移入新的分块，已读取的完整语句作为分块加入队列
+		const size_t rest = n - end;
+		const size_t capacity = ctxmem->src_capacity > rest ? ctxmem->src_capacity : rest;
+
+		srcchunk_t *next = se_ctx_source_chunk(capacity);
+		assert(next != 0L);
+		memcpy(next->text, buffer + end, rest);
+		next->len = rest;
+		next->text[rest] = '\0';
+
+		pending->len -= rest;
+		pending->text[pending->len] = '\0';
+
+		ctxmem->src_pending  = next;
+		ctxmem->src_capacity = capacity;
+
+		se_ctx_source_push(ctx, pending);
+
+		return 1;
+	}
+
+	return 0;
+}
+
+// 释放已读完的分块并切换到下一个分块，返回其起始地址，没有更多代码时返回0L
+static const char* se_ctx_source_next(se_context_t *ctx)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	int old_mempool_id = se_current_allocator();
+	se_allocator_set(ctxmem->mempool_id);
+
+	srcchunk_t *chunk = ctxmem->src_head;
+	if (chunk != 0L)
+	{
+		ctxmem->src_head = chunk->next;
+		if (ctxmem->src_head == 0L)
+		{
+			ctxmem->src_tail = 0L;
+		}
+		se_ctx_source_unmap(chunk);
+		se_free(chunk);
+	}
+
+	ctx->next_statement = 0L;
+
+	if (ctxmem->src_head == 0L)
+	{	// se_ctx_source_push会更新next_statement
+		se_ctx_source_pull(ctx);
+	} else
+	{
+		ctx->next_statement = ctxmem->src_head->text;
+	}
+
+	se_allocator_set(old_mempool_id);
+
+	return ctx->next_statement;
+}
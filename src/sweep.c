@@ -0,0 +1,224 @@
+#ifndef SE_CONTEXT_BUILD
+#error sweep.c is only available in context.c
+#endif
+
+#define SE_SWEEP_TRIM (256 * 1024) // 累计回收的字节数达到此值后归还空闲内存块
+
+static inline size_t markset_hash(const void *p, size_t mask)
+{
+	uint64_t h = (uint64_t)(uintptr_t)p >> 3;
+	h *= 0x9e3779b97f4a7c15ull;
+	return (size_t)(h >> 32) & mask;
+}
+
+static int markset_init(markset_t *set, size_t hint)
+{
+	size_t capacity = 64;
+	while (capacity < hint * 2)
+	{
+		capacity <<= 1;
+	}
+
+	set->slots = (const void**)se_alloc(sizeof(void*) * capacity);
+	if (set->slots == 0L)
+	{
+		return 1;
+	}
+
+	memset(set->slots, 0, sizeof(void*) * capacity);
+	set->size = 0;
+	set->capacity = capacity;
+
+	return 0;
+}
+
+// 清空集合以供本次回收使用，容量与需求相差不大时复用原有的槽位
+static int markset_reset(markset_t *set, size_t hint)
+{
+	size_t capacity = 64;
+	while (capacity < hint * 2)
+	{
+		capacity <<= 1;
+	}
+
+	if (set->slots != 0L && set->capacity >= capacity && set->capacity <= capacity * 8)
+	{
+		memset(set->slots, 0, sizeof(void*) * set->capacity);
+		set->size = 0;
+		return 0;
+	}
+
+	se_free((void*)set->slots);
+	set->slots = 0L;
+	return markset_init(set, hint);
+}
+
+static int markset_contains(const markset_t *set, const void *p)
+{
+	const size_t mask = set->capacity - 1;
+	size_t i = markset_hash(p, mask);
+	while (set->slots[i] != 0L)
+	{
+		if (set->slots[i] == p) return 1;
+		i = (i + 1) & mask;
+	}
+	return 0;
+}
+
+// 插入指针，返回1表示新插入，0表示已存在，-1表示内存不足
+static int markset_insert(markset_t *set, const void *p)
+{
+	if ((set->size + 1) * 2 > set->capacity)
+	{	// 负载超过一半时扩容
+		markset_t tmp;
+		if (markset_init(&tmp, set->capacity) != 0)
+		{
+			return -1;
+		}
+		for (size_t i = 0; i < set->capacity; ++i)
+		{
+			if (set->slots[i] != 0L)
+			{
+				markset_insert(&tmp, set->slots[i]);
+			}
+		}
+		se_free((void*)set->slots);
+		*set = tmp;
+	}
+
+	const size_t mask = set->capacity - 1;
+	size_t i = markset_hash(p, mask);
+	while (set->slots[i] != 0L)
+	{
+		if (set->slots[i] == p) return 0;
+		i = (i + 1) & mask;
+	}
+
+	set->slots[i] = p;
+	++set->size;
+
+	return 1;
+}
+
+// 从对象出发标记所有可达的内存
+static int se_ctx_mark(markset_t *set, const se_object_t *obj)
+{
+	while (obj != 0L && obj->data != 0L)
+	{
+		int state = markset_insert(set, obj->data);
+		if (state <= 0)
+		{	// 已标记或内存不足
+			return state;
+		}
+
+		if (obj->type == EO_OBJ)
+		{
+			obj = (const se_object_t*)obj->data;
+			continue;
+		}
+
+		if (obj->type == EO_ARRAY)
+		{
+			const se_array_t *array = (const se_array_t*)obj->data;
+			if (array->data == 0L) return 0;
+
+			state = markset_insert(set, array->data);
+			if (state <= 0) return state;
+
+			for (size_t i = 0; i < array->size; ++i)
+			{
+				if (se_ctx_mark(set, &array->data[i]) < 0)
+				{
+					return -1;
+				}
+			}
+		}
+
+		break;
+	}
+
+	return 0;
+}
+
+// 回收临时内存记录中不可达的部分，返回回收的记录数并累计回收的字节数，失败时返回-1
+static int se_ctx_collect(se_context_t *ctx, size_t *bytes)
+{
+	ctxmemory_t *ctxmem = (ctxmemory_t*)ctx->memory;
+
+	markset_t *set = &ctxmem->markset;
+	if (markset_reset(set, ctxmem->tmpstorage_size) != 0)
+	{
+		return -1;
+	}
+
+	int state = 0;
+
+	// 根集合：绑定中的id对象（已解绑的除外）与上次的执行结果
+	for (size_t i = 0; i < ctxmem->idstorage_capacity && state >= 0; ++i)
+	{
+		const se_object_t *obj = &ctxmem->idstorage[i];
+		if (obj->id == i + 1 && !obj->is_nil)
+		{
+			state = se_ctx_mark(set, obj);
+		}
+	}
+
+	if (state >= 0 && !ctxmem->result.is_nil)
+	{
+		state = se_ctx_mark(set, &ctxmem->result);
+	}
+
+	if (state < 0)
+	{	// 标记不完整时放弃回收
+		return -1;
+	}
+
+	// 预留待归还的id，回收途中不再申请内存
+	size_t i = 0, nids = 0;
+	for (; i < ctxmem->tmpstorage_size; ++i)
+	{
+		const tmpnode_t *node = &ctxmem->tmpstorage[i];
+		if (!markset_contains(set, node->ptr))
+		{
+			nids += node->kind == TMP_OBJECT ? 1 : node->kind == TMP_ELEMENTS ? node->count : 0;
+		}
+	}
+
+	if (se_ctx_reserve_freeids(ctx, nids) != 0)
+	{
+		return -1;
+	}
+
+	size_t n = 0;
+	int count = 0;
+	for (i = 0; i < ctxmem->tmpstorage_size; ++i)
+	{
+		tmpnode_t *node = &ctxmem->tmpstorage[i];
+		if (markset_contains(set, node->ptr))
+		{
+			ctxmem->tmpstorage[n++] = *node;
+			continue;
+		}
+
+		if (node->kind == TMP_OBJECT)
+		{
+			se_ctx_releaseid(ctx, ((se_object_t*)node->ptr)->id);
+		} else if (node->kind == TMP_ELEMENTS)
+		{
+			se_object_t *elements = (se_object_t*)node->ptr;
+			for (size_t c = 0; c < node->count; ++c)
+			{
+				se_ctx_releaseid(ctx, elements[c].id);
+			}
+		}
+
+		*bytes += se_msize(node->ptr);
+		se_free(node->ptr);
+		++count;
+	}
+
+	ctxmem->tmpstorage_size = n;
+
+	return count;
+}
+
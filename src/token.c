@@ -10,39 +10,94 @@ void reset_token(token_t *pt)
 	}
 }
 
+// 字符分类表，按首字符直接得到词法单元的主类型
+static const unsigned char g_chtype[256] =
+{
+	['\0'] = T_NULL,
+
+	['\r'] = T_INDENT, ['\n'] = T_INDENT, ['\t'] = T_INDENT, [' '] = T_INDENT,
+
+	['0'] = T_NUMBER, ['1'] = T_NUMBER, ['2'] = T_NUMBER, ['3'] = T_NUMBER,
+	['4'] = T_NUMBER, ['5'] = T_NUMBER, ['6'] = T_NUMBER, ['7'] = T_NUMBER,
+	['8'] = T_NUMBER, ['9'] = T_NUMBER, ['.'] = T_NUMBER,
+
+	['A'] = T_SYMBOL, ['B'] = T_SYMBOL, ['C'] = T_SYMBOL, ['D'] = T_SYMBOL,
+	['E'] = T_SYMBOL, ['F'] = T_SYMBOL, ['G'] = T_SYMBOL, ['H'] = T_SYMBOL,
+	['I'] = T_SYMBOL, ['J'] = T_SYMBOL, ['K'] = T_SYMBOL, ['L'] = T_SYMBOL,
+	['M'] = T_SYMBOL, ['N'] = T_SYMBOL, ['O'] = T_SYMBOL, ['P'] = T_SYMBOL,
+	['Q'] = T_SYMBOL, ['R'] = T_SYMBOL, ['S'] = T_SYMBOL, ['T'] = T_SYMBOL,
+	['U'] = T_SYMBOL, ['V'] = T_SYMBOL, ['W'] = T_SYMBOL, ['X'] = T_SYMBOL,
+	['Y'] = T_SYMBOL, ['Z'] = T_SYMBOL,
+	['a'] = T_SYMBOL, ['b'] = T_SYMBOL, ['c'] = T_SYMBOL, ['d'] = T_SYMBOL,
+	['e'] = T_SYMBOL, ['f'] = T_SYMBOL, ['g'] = T_SYMBOL, ['h'] = T_SYMBOL,
+	['i'] = T_SYMBOL, ['j'] = T_SYMBOL, ['k'] = T_SYMBOL, ['l'] = T_SYMBOL,
+	['m'] = T_SYMBOL, ['n'] = T_SYMBOL, ['o'] = T_SYMBOL, ['p'] = T_SYMBOL,
+	['q'] = T_SYMBOL, ['r'] = T_SYMBOL, ['s'] = T_SYMBOL, ['t'] = T_SYMBOL,
+	['u'] = T_SYMBOL, ['v'] = T_SYMBOL, ['w'] = T_SYMBOL, ['x'] = T_SYMBOL,
+	['y'] = T_SYMBOL, ['z'] = T_SYMBOL, ['_'] = T_SYMBOL,
+
+	[','] = T_OPERATOR, [';'] = T_OPERATOR, ['('] = T_OPERATOR, [')'] = T_OPERATOR,
+	['['] = T_OPERATOR, [']'] = T_OPERATOR, ['{'] = T_OPERATOR, ['}'] = T_OPERATOR,
+	['+'] = T_OPERATOR, ['-'] = T_OPERATOR, ['%'] = T_OPERATOR, ['*'] = T_OPERATOR,
+	['/'] = T_OPERATOR, ['&'] = T_OPERATOR, ['|'] = T_OPERATOR, ['^'] = T_OPERATOR,
+	['~'] = T_OPERATOR, ['>'] = T_OPERATOR, ['<'] = T_OPERATOR, ['='] = T_OPERATOR,
+	['!'] = T_OPERATOR,
+};
+
 int predict(const char *s)
 {
 	if (s == 0L) return T_INVALID;
 
-	const char c = s[0];
+	return g_chtype[(unsigned char)s[0]];
+}
 
-	if (c == '\0')
-	{
-		return T_NULL;
-	}
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
 
-	if (c == '\r' || c == '\n' || c == '\t' || c == ' ')
-	{
-		return T_INDENT;
-	}
+#if defined(__SANITIZE_ADDRESS__)
+#define SE_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define SE_NO_SANITIZE_ADDRESS
+#endif
 
-	if (c >= '0' && c <= '9' || c == '.')
+// 统计从q开始连续为c1或c2的字符数，每次比较16字节
+// 对齐读取不会跨越内存页，即使越过字符串结尾也是安全的
+SE_NO_SANITIZE_ADDRESS
+static size_t se_span_of(const char *q, char c1, char c2)
+{
+	const char *p = q;
+
+	while (((uintptr_t)p & 15) != 0)
 	{
-		return T_NUMBER;
+		if (*p != c1 && *p != c2) return p - q;
+		++p;
 	}
 
-	if (c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c == '_')
+	const __m128i v1 = _mm_set1_epi8(c1);
+	const __m128i v2 = _mm_set1_epi8(c2);
+
+	for (;; p += 16)
 	{
-		return T_SYMBOL;
+		const __m128i chunk = _mm_load_si128((const __m128i*)p);
+		const __m128i match = _mm_or_si128(
+			_mm_cmpeq_epi8(chunk, v1), _mm_cmpeq_epi8(chunk, v2));
+		const unsigned mask = (unsigned)_mm_movemask_epi8(match) ^ 0xffff;
+		if (mask != 0)
+		{
+			return p - q + __builtin_ctz(mask);
+		}
 	}
+}
 
-	const char *op_charset = ",;()[]{}+-%*/&|^~><=!", *p = op_charset;
-	do {
-		if (c == *p) return T_OPERATOR;
-	} while (*++p != '\0');
-
-	return T_INVALID;
+#undef SE_NO_SANITIZE_ADDRESS
+#else
+static size_t se_span_of(const char *q, char c1, char c2)
+{
+	const char *p = q;
+	while (*p == c1 || *p == c2) ++p;
+	return p - q;
 }
+#endif
 
 size_t get_invalid(const char *s, token_t *pt)
 {
@@ -72,13 +127,8 @@ size_t get_null(const char *s, token_t *pt)
 
 size_t get_indent(const char *s, token_t *pt)
 {
-#define T1(c) ((c) == '\r' || (c) == '\n')
-#define T2(c) ((c) == '\t')
-#define T3(c) ((c) == ' ')
-#define T4(c) (T1(c) || T2(c) || T3(c))
-
-	const char *p = s, *q = p;
-	if (!T4(*p))
+	const char *p = s;
+	if (g_chtype[(unsigned char)*p] != T_INDENT)
 	{
 		reset_token(pt);
 		return 0;
@@ -86,28 +136,23 @@ size_t get_indent(const char *s, token_t *pt)
 
 	size_t len = 0;
 
-	switch (*q)
+	switch (*p)
 	{
 		case '\r': 
-		case '\n': do { ++len; } while ((++q, T1(*q)));
+		case '\n': len = se_span_of(p, '\r', '\n');
 		           pt->sub_type = T_IDT_NEWLINE; break;
-		case '\t': do { ++len; } while ((++q, T2(*q)));
+		case '\t': len = se_span_of(p, '\t', '\t');
 		           pt->sub_type = T_IDT_TAB; break;
-		case ' ':  do { ++len; } while ((++q, T3(*q)));
+		case ' ':  len = se_span_of(p, ' ', ' ');
 		           pt->sub_type = T_IDT_BLANK; break;
 	}
 
 	pt->p    = p;
-	pt->q    = q - 1;
-	pt->r    = q;
+	pt->q    = p + len - 1;
+	pt->r    = p + len;
 	pt->type = T_INDENT;
 
 	return len;
-
-#undef T1
-#undef T2
-#undef T3
-#undef T4
 }
 
 size_t get_number(const char *s, token_t *pt)
@@ -282,7 +327,7 @@ _done:
 
 size_t get_symbol(const char *s, token_t *pt)
 {
-#define T1(c) ((c) >= 'a' && (c) <= 'z' || (c) >= 'A' && (c) <= 'Z' || (c) == '_')
+#define T1(c) (g_chtype[(unsigned char)(c)] == T_SYMBOL)
 #define T2(c) (T1(c) || (c) >= '0' && (c) <= '9')
 
 	const char *p = s, *q = p;
@@ -313,17 +358,11 @@ size_t get_symbol(const char *s, token_t *pt)
 
 size_t get_operator(const char *s, token_t *pt)
 {
-#define T1(c) ((c) == '(' || (c) == '[' || (c) == '{')
-#define T2(c) ((c) == ')' || (c) == ']' || (c) == '}')
-#define T3(c) (T1(c) || T2(c))
-#define T4(c) ((c) == '+' || (c) == '-' || (c) == '%' || (c) == '*' || (c) == '/')
-#define T5(c) ((c) == '=' || (c) == '>' || (c) == '<' || (c) == '!')
-#define T6(c) ((c) == '&' || (c) == '|' || (c) == '^' || (c) == '~')
-#define T7(c) ((c) == ',' || (c) == ';' || T3(c) || T4(c) || T5(c) || T6(c))
+#define T1(c) (g_chtype[(unsigned char)(c)] == T_OPERATOR)
 
 	const char *p = s, *q = p;
 
-	if (!T7(*p))
+	if (!T1(*p))
 	{
 		reset_token(pt);
 		return 0;
@@ -415,12 +454,6 @@ _done:
 	return len;
 
 #undef T1
-#undef T2
-#undef T3
-#undef T4
-#undef T5
-#undef T6
-#undef T7
 }
 
 fn_getter se_getter(int type)
@@ -3,7 +3,6 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
-#include <errno.h>
 #include <limits.h>
 
 se_number_t parse_int_number(int32_t x, int type)
@@ -34,6 +33,148 @@ se_number_t parse_flt_number(double x)
 	return ret;
 }
 
+// 10的0至22次幂均可被double精确表示
+static const double g_pow10[] =
+{
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+	1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+#define MAX_EXACT_POW10 22
+#define MAX_EXACT_INT   (1ull << 53)
+
+static inline int digit_of(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return 16;
+}
+
+// 在词法单元上直接累加整数，超出int32范围时置inf
+// 十进制的上限为INT32_MAX（超出时由parse_number改按浮点数解析），其余进制按32位补码解释（如0xffffffff为-1）
+static se_number_t parse_int_span(const char *s, const char *q, int radix, int type)
+{
+	const uint64_t limit = radix == 10 ? INT32_MAX : UINT32_MAX;
+
+	uint64_t v = 0;
+	int overflow = 0;
+
+	for (; s <= q; ++s)
+	{
+		v = v * radix + digit_of(*s);
+		if (v > limit)
+		{	// 保留低32位，与整数运算溢出时的结果一致
+			overflow = 1;
+			v &= UINT32_MAX;
+		}
+	}
+
+	se_number_t ret = { 0 };
+	ret.i    = (int32_t)(uint32_t)v;
+	ret.inf  = overflow;
+	ret.type = type;
+
+	return ret;
+}
+
+// 浮点数字面量：有效数字不超过19位且能精确表示时直接计算（Clinger快速路径）
+// 结果与strtod一致地正确舍入，其余情况在栈上复制后交由strtod
+static double parse_flt_span(const char *p, const char *q)
+{
+	uint64_t w = 0;
+	int ndigits = 0, exp10 = 0, exact = 1;
+	const char *s = p;
+
+	for (; s <= q && *s >= '0' && *s <= '9'; ++s)
+	{
+		if (w == 0 && *s == '0') continue;
+		if (++ndigits > 19) exact = 0;
+		w = w * 10 + (*s - '0');
+	}
+
+	if (s <= q && *s == '.')
+	{
+		for (++s; s <= q && *s >= '0' && *s <= '9'; ++s)
+		{
+			if (w == 0 && *s == '0')
+			{
+				--exp10;
+				continue;
+			}
+			if (++ndigits > 19) exact = 0;
+			w = w * 10 + (*s - '0');
+			--exp10;
+		}
+	}
+
+	if (s <= q && (*s == 'e' || *s == 'E'))
+	{
+		int sign = 1, e = 0;
+		++s;
+		if (s <= q && (*s == '+' || *s == '-'))
+		{
+			sign = *s++ == '-' ? -1 : 1;
+		}
+		for (; s <= q; ++s)
+		{
+			if (e < 100000) e = e * 10 + (*s - '0');
+		}
+		exp10 += sign * e;
+	}
+
+	if (exact && w == 0)
+	{
+		return 0.0;
+	}
+
+	if (exact && w <= MAX_EXACT_INT)
+	{
+		if (exp10 >= 0 && exp10 <= MAX_EXACT_POW10)
+		{
+			return (double)w * g_pow10[exp10];
+		}
+		if (exp10 < 0 && exp10 >= -MAX_EXACT_POW10)
+		{
+			return (double)w / g_pow10[-exp10];
+		}
+		if (exp10 > MAX_EXACT_POW10 && exp10 <= MAX_EXACT_POW10 + 15)
+		{	// 先将多余的幂并入尾数，尾数仍可精确表示时结果正确舍入
+			uint64_t m = w;
+			int k = exp10 - MAX_EXACT_POW10;
+			while (k-- > 0 && m <= MAX_EXACT_INT)
+			{
+				m *= 10;
+			}
+			if (m <= MAX_EXACT_INT)
+			{
+				return (double)m * g_pow10[MAX_EXACT_POW10];
+			}
+		}
+	}
+
+	char buffer[128];
+	const size_t len = q - p + 1;
+	char *copy = len < sizeof(buffer) ? buffer : (char*)malloc(len + 1);
+	if (copy == 0L)
+	{
+		return NAN;
+	}
+
+	memcpy(copy, p, len);
+	copy[len] = '\0';
+
+	double f = strtod(copy, 0L);
+
+	if (copy != buffer)
+	{
+		free(copy);
+	}
+
+	return f;
+}
+
 se_number_t parse_number(const token_t *pt)
 {
 	se_number_t ret = { 0 };
@@ -42,32 +183,35 @@ se_number_t parse_number(const token_t *pt)
 	{
 		ret.type = EN_DEC;
 		ret.nan  = 1;
-	} else
+		return ret;
+	}
+
+	switch (pt->sub_type)
 	{
-		const int len = pt->q - pt->p + 1;
-		char *s = (char*)calloc(len + 1, sizeof(char));
-		memcpy(s, pt->p, len);
-		s[len] = '\0';
-		if (pt->sub_type == T_NUM_FLT || pt->sub_type == T_NUM_EEEE)
+		case T_NUM_FLT:
+		case T_NUM_EEEE:
 		{
-			ret.f    = strtod(s, 0L);
+			ret.f    = parse_flt_span(pt->p, pt->q);
 			ret.inf  = isinf(ret.f);
+			ret.nan  = isnan(ret.f);
 			ret.type = EN_FLT;
-		} else
+		}
+		break;
+		case EN_BIN: ret = parse_int_span(pt->p + 2, pt->q, 2,  EN_BIN); break;
+		case EN_OCT: ret = parse_int_span(pt->p + 1, pt->q, 8,  EN_OCT); break;
+		case EN_HEX: ret = parse_int_span(pt->p + 2, pt->q, 16, EN_HEX); break;
+		default:
 		{
-			int radix, offset;
-			switch (pt->sub_type)
-			{
-				case EN_BIN: radix = 2;  offset = 2; break;
-				case EN_OCT: radix = 8;  offset = 1; break;
-				case EN_DEC: radix = 10; offset = 0; break;
-				case EN_HEX: radix = 16; offset = 2; break;
+			ret = parse_int_span(pt->p, pt->q, 10, EN_DEC);
+			if (ret.inf)
+			{	// 超出int32范围的十进制整数按浮点数解析，-2147483648即对2147483648.0取负
+				ret.f    = parse_flt_span(pt->p, pt->q);
+				ret.inf  = isinf(ret.f);
+				ret.type = EN_FLT;
 			}
-			ret.i    = strtol(s + offset, 0L, radix);
-			ret.inf  = ret.i == LONG_MAX && errno == ERANGE;
-			ret.type = pt->sub_type;
 		}
+		break;
 	}
 
 	return ret;
-}
\ No newline at end of file
+}
@@ -0,0 +1,193 @@
+#include <se/alloc.h>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+class allocTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		old_ = se_current_allocator();
+		id_  = se_allocator_create(0);
+		ASSERT_EQ(se_allocator_set(id_), 0);
+	}
+
+	void TearDown() override
+	{
+		se_allocator_set(old_);
+		EXPECT_EQ(se_allocator_destroy(id_), 0);
+	}
+
+	int old_, id_;
+};
+
+TEST_F(allocTest, SizeClassReuse)
+{
+	void *a = se_alloc(20);
+	void *b = se_alloc(24);
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	EXPECT_EQ(se_msize(a), 24u);
+
+	se_free(a);
+	EXPECT_EQ(se_alloc(17), a); // 同尺寸类别立即复用
+
+	se_free(b);
+	void *c = se_alloc(32);
+	EXPECT_NE(c, b); // 不同尺寸类别互不复用
+	EXPECT_EQ(se_alloc(24), b);
+}
+
+TEST_F(allocTest, FreedMemoryDoesNotGrowPool)
+{
+	void *first[64];
+	for (int i = 0; i < 64; ++i)
+	{
+		first[i] = se_alloc(8 + i % 8 * 8);
+	}
+	for (int i = 0; i < 64; ++i)
+	{
+		se_free(first[i]);
+	}
+
+	for (int round = 0; round < 1000; ++round)
+	{
+		void *p[64];
+		for (int i = 0; i < 64; ++i)
+		{
+			p[i] = se_alloc(8 + i % 8 * 8);
+		}
+		for (int i = 0; i < 64; ++i)
+		{	// 释放后的内存段全部来自首轮分配
+			EXPECT_NE(std::find(first, first + 64, p[i]), first + 64);
+			se_free(p[i]);
+		}
+	}
+}
+
+TEST_F(allocTest, Realloc)
+{
+	char *p = (char*)se_alloc(16);
+	memcpy(p, "0123456789abcde", 16);
+
+	EXPECT_EQ(se_realloc(p, 10), p);
+
+	char *q = (char*)se_realloc(p, 1024);
+	ASSERT_NE(q, nullptr);
+	EXPECT_STREQ(q, "0123456789abcde");
+	EXPECT_EQ(q[1023], 0);
+	se_free(q);
+}
+
+TEST_F(allocTest, OwnerLookupAcrossBlocks)
+{
+	void *p[200];
+	for (int i = 0; i < 200; ++i)
+	{	// 跨越多个内存块的大内存段
+		p[i] = se_alloc(257 + i * 13);
+		ASSERT_NE(p[i], nullptr);
+		memset(p[i], i & 0xff, 257 + i * 13);
+	}
+
+	for (int i = 0; i < 200; ++i)
+	{
+		EXPECT_EQ(se_msize(p[i]), (257 + i * 13 + 7u) & ~7u);
+		EXPECT_EQ(((unsigned char*)p[i])[256], i & 0xff);
+	}
+
+	for (int i = 0; i < 200; i += 2)
+	{
+		se_free(p[i]);
+	}
+	for (int i = 1; i < 200; i += 2)
+	{
+		se_free(p[i]);
+	}
+
+	se_alloc_trim();
+	void *q = se_alloc(4096);
+	ASSERT_NE(q, nullptr);
+	EXPECT_EQ(se_msize(q), 4096u);
+	se_free(q);
+}
+
+TEST_F(allocTest, IdleBlocksReusedBySizes)
+{
+	std::vector<void*> small;
+	for (int i = 0; i < 4000; ++i)
+	{	// 小内存段占满多个内存块
+		small.push_back(se_alloc(64));
+	}
+	for (void *p : small)
+	{
+		se_free(p);
+	}
+
+	// 小内存段全部释放后其内存块可供其他尺寸复用，内存池不必拓展
+	std::vector<void*> large;
+	bool reused = false;
+	for (int i = 0; i < 64 && !reused; ++i)
+	{
+		large.push_back(se_alloc(4096));
+		ASSERT_NE(large.back(), nullptr);
+		reused = std::find(small.begin(), small.end(), large.back()) != small.end();
+	}
+	EXPECT_TRUE(reused);
+	for (void *p : large)
+	{
+		se_free(p);
+	}
+
+	se_alloc_trim();
+	void *r = se_alloc(64);
+	ASSERT_NE(r, nullptr);
+	se_free(r);
+}
+
+TEST(allocThreadTest, PerThreadAllocators)
+{
+	std::vector<int> failures(8, 0);
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 8; ++t)
+	{
+		threads.emplace_back([t, &failures]() {
+			// 每个线程的当前内存分配器互不影响
+			EXPECT_EQ(se_current_allocator(), 0);
+			int id = se_allocator_create(0);
+			se_allocator_set(id);
+
+			for (int round = 0; round < 200; ++round)
+			{
+				unsigned char *p[32];
+				for (int i = 0; i < 32; ++i)
+				{
+					p[i] = (unsigned char*)se_alloc(16 + i * 24);
+					memset(p[i], t, 16 + i * 24);
+				}
+				for (int i = 0; i < 32; ++i)
+				{
+					if (p[i][0] != t || p[i][15 + i * 24] != t) ++failures[t];
+					se_free(p[i]);
+				}
+			}
+
+			EXPECT_EQ(se_current_allocator(), id);
+			se_allocator_restore();
+			EXPECT_EQ(se_allocator_destroy(id), 0);
+		});
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	for (int t = 0; t < 8; ++t)
+	{
+		EXPECT_EQ(failures[t], 0);
+	}
+}
@@ -0,0 +1,1245 @@
+#include <se/context.h>
+#include <se/exception.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <regex>
+#include <string>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+static const se_number_t* last_number(se_context_t *ctx)
+{
+	const se_object_t *ret = se_ctx_get_last_ret(ctx);
+	if (ret == 0L) return 0L;
+
+	while (ret->type == EO_OBJ)
+	{
+		ret = (const se_object_t*)ret->data;
+	}
+
+	return ret->type == EO_NUM ? (const se_number_t*)ret->data : 0L;
+}
+
+static int eval(se_context_t *ctx, const char *script)
+{
+	se_ctx_load(ctx, script);
+	while (se_ctx_complete(ctx) != 0)
+	{
+		if (se_ctx_forward(ctx) != 0) return 1;
+		se_ctx_parse(ctx);
+		if (se_ctx_execute(ctx) != 0) return 1;
+	}
+	return 0;
+}
+
+TEST(contextTest, CompileOnceRunMany)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	se_program_t init, step, expr;
+	ASSERT_EQ(se_ctx_compile(&ctx, "x = 0", &init), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, "x += 1", &step), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, "x * 2 + 1; ignored", &expr), 0);
+
+	ASSERT_EQ(se_ctx_run(&ctx, &init), 0);
+	for (int i = 1; i <= 100; ++i)
+	{
+		ASSERT_EQ(se_ctx_run(&ctx, &step), 0);
+		ASSERT_EQ(se_ctx_run(&ctx, &expr), 0);
+
+		const se_number_t *num = last_number(&ctx);
+		ASSERT_NE(num, nullptr);
+		EXPECT_EQ(num->i, i * 2 + 1);
+	}
+
+	se_ctx_discard(&ctx, &init);
+	se_ctx_discard(&ctx, &step);
+	se_ctx_discard(&ctx, &expr);
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, LiteralPoolIsImmutable)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	se_program_t init, step, expr;
+	ASSERT_EQ(se_ctx_compile(&ctx, "x = 5, y = 0x10", &init), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, "x += 1, y *= 2", &step), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, "x * 1.5 + y - 5", &expr), 0);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		ASSERT_EQ(se_ctx_run(&ctx, &init), 0);
+		ASSERT_EQ(se_ctx_run(&ctx, &step), 0);
+		ASSERT_EQ(se_ctx_run(&ctx, &expr), 0);
+
+		const se_number_t *num = last_number(&ctx);
+		ASSERT_NE(num, nullptr);
+		EXPECT_DOUBLE_EQ(num->f, 6 * 1.5 + 32 - 5);
+	}
+
+	se_ctx_discard(&ctx, &init);
+	se_ctx_discard(&ctx, &step);
+	se_ctx_discard(&ctx, &expr);
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, InternedSymbolsFollowUnbind)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	// 编译时符号尚不存在，首次执行时创建并记录
+	se_program_t init, expr;
+	ASSERT_EQ(se_ctx_compile(&ctx, "v = 3", &init), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, "v * 2 + w", &expr), 0);
+
+	se_number_t w = { 0 };
+	w.i = 1;
+	ASSERT_EQ(se_ctx_bind(&ctx, &w, EO_NUM, "w"), 0);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		ASSERT_EQ(se_ctx_run(&ctx, &init), 0);
+		ASSERT_EQ(se_ctx_run(&ctx, &expr), 0);
+		EXPECT_EQ(last_number(&ctx)->i, 7);
+	}
+
+	// 解绑定后重新绑定的符号使用新的id
+	ASSERT_EQ(se_ctx_unbind(&ctx, "w"), 0);
+	w.i = 10;
+	ASSERT_EQ(se_ctx_bind(&ctx, &w, EO_NUM, "w"), 0);
+	ASSERT_EQ(se_ctx_run(&ctx, &expr), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 16);
+
+	ASSERT_EQ(eval(&ctx, "v = 5"), 0);
+	ASSERT_EQ(se_ctx_run(&ctx, &expr), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 20);
+
+	se_ctx_discard(&ctx, &init);
+	se_ctx_discard(&ctx, &expr);
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, ManySymbols)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	// 符号表在插入过程中多次扩容
+	const int n = 10000;
+	std::vector<std::string> names(n);
+	for (int i = 0; i < n; ++i)
+	{
+		names[i] = "v" + std::to_string(i);
+		se_number_t num = { 0 };
+		num.i = i;
+		ASSERT_EQ(se_ctx_bind(&ctx, &num, EO_NUM, names[i].c_str()), 0);
+	}
+
+	ASSERT_EQ(eval(&ctx, "v0 + v1 + v4999 + v9999"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 0 + 1 + 4999 + 9999);
+
+	for (int i = 0; i < n; i += 2)
+	{
+		EXPECT_EQ(se_ctx_unbind(&ctx, names[i].c_str()), 0) << names[i];
+	}
+	for (int i = 0; i < n; i += 2)
+	{
+		EXPECT_NE(se_ctx_unbind(&ctx, names[i].c_str()), 0) << names[i];
+	}
+
+	long long sum = 0;
+	std::string expr = "0";
+	for (int i = 1; i < n; i += 1000)
+	{
+		expr += " + v" + std::to_string(i);
+		sum += i;
+	}
+	ASSERT_EQ(eval(&ctx, expr.c_str()), 0);
+	EXPECT_EQ(last_number(&ctx)->i, sum);
+
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, ProgramOutlivesScript)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	char script[] = "y = 3; y * y";
+	se_program_t prog;
+
+	ASSERT_EQ(eval(&ctx, script), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, script + 7, &prog), 0);
+	memset(script, ' ', sizeof(script) - 1);
+
+	ASSERT_EQ(eval(&ctx, "y = 5"), 0);
+	ASSERT_EQ(se_ctx_run(&ctx, &prog), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 25);
+
+	se_ctx_discard(&ctx, &prog);
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, CompileError)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	se_exception_t e;
+	se_program_t prog;
+
+	EXPECT_NE(se_ctx_compile(&ctx, "(1 + 2", &prog), 0);
+	EXPECT_EQ(se_catch(&e, SyntaxError), 1);
+
+	EXPECT_NE(se_ctx_compile(&ctx, "   ", &prog), 0);
+	EXPECT_EQ(se_caught(), 1);
+
+	ASSERT_EQ(se_ctx_compile(&ctx, "1 / 0", &prog), 0);
+	EXPECT_NE(se_ctx_run(&ctx, &prog), 0);
+	EXPECT_EQ(se_catch_err(&e, RuntimeError, IntDivOrModByZero), 1);
+
+	se_ctx_discard(&ctx, &prog);
+	se_ctx_destroy(&ctx);
+}
+
+// 执行程序，返回结果数值或异常
+static int run_number(se_context_t *ctx, const char *script, se_number_t *num, se_exception_t *e)
+{
+	se_program_t prog;
+	if (se_ctx_compile(ctx, script, &prog) != 0)
+	{
+		se_catch_any(e);
+		return -1;
+	}
+
+	int state = se_ctx_run(ctx, &prog);
+	if (state != 0)
+	{
+		se_catch_any(e);
+	} else
+	{
+		const se_number_t *p = last_number(ctx);
+		state = p == 0L ? -1 : 0;
+		if (p != 0L) *num = *p;
+	}
+
+	se_ctx_discard(ctx, &prog);
+	return state;
+}
+
+TEST(contextTest, ConstantFolding)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	se_program_t prog;
+	ASSERT_EQ(se_ctx_compile(&ctx, "2 * 3.14 + (1) - -(0x0f & ~1)", &prog), 0);
+	EXPECT_EQ(prog.seus.nus, 1);
+	se_ctx_discard(&ctx, &prog);
+
+	ASSERT_EQ(se_ctx_compile(&ctx, "x * (1 + 2)", &prog), 0);
+	EXPECT_EQ(prog.seus.nus, 3);
+	se_ctx_discard(&ctx, &prog);
+
+	// 非常量操作数的恒等式有意保留：运算同时检查操作数为数字并规范数值类型，删去将改变结果
+	const struct { const char *expr; int nus; } identities[] = {
+		{ "+x", 2 }, { "x * 1", 3 }, { "x + 0", 3 },
+	};
+	for (const auto &identity : identities)
+	{
+		ASSERT_EQ(se_ctx_compile(&ctx, identity.expr, &prog), 0) << identity.expr;
+		EXPECT_EQ(prog.seus.nus, identity.nus) << identity.expr;
+		se_ctx_discard(&ctx, &prog);
+	}
+
+	{
+		se_number_t num = { 0 };
+		se_exception_t e = { 0 };
+		ASSERT_EQ(eval(&ctx, "x = { 1, 2 }"), 0);
+		EXPECT_NE(run_number(&ctx, "+x", &num, &e), 0);
+		EXPECT_EQ(e.etype, TypeError);
+		EXPECT_NE(run_number(&ctx, "x * 1", &num, &e), 0);
+		EXPECT_EQ(e.etype, TypeError);
+
+		ASSERT_EQ(eval(&ctx, "x = 0xff"), 0);
+		ASSERT_EQ(run_number(&ctx, "x * 1", &num, &e), 0);
+		EXPECT_EQ(num.type, EN_DEC);
+		EXPECT_EQ(num.i, 255);
+	}
+
+	// 以符号替换字面量的表达式不会被折叠，两者结果（含异常）须完全一致
+	const char *exprs[] = {
+		"2 * 3.14", "~0x0f", "-(1)", "+(2) * (3 + 4)", "(1 + 2) * (3 - 4) / 2",
+		"7 % 3 + 10 / 4", "1 / 0", "1 % 0", "2.5 % 2", "~1.5", "2147483647 + 1",
+		"-2147483647 - 2", "0x10 | 3 ^ 5", "1 << 33", "!0 + !2.5",
+		"3 > 2 && 1.5 <= 1", "(1, 2) + 3", "-(-(3))", "1.0 / 0",
+		"(2147483647 * 2) + 1", "((((1)))) * ((2) + (3.5))", "x = (1 + 2) * 3",
+		"-2147483648", "2147483648 + 1",
+	};
+
+	const std::regex literal("0[xX][0-9a-fA-F]+|[0-9]+\\.[0-9]+|[0-9]+");
+	for (const char *expr : exprs)
+	{
+		std::string text(expr), replaced;
+		std::sregex_iterator it(text.begin(), text.end(), literal), end;
+		size_t last = 0;
+		int k = 0;
+		for (; it != end; ++it, ++k)
+		{
+			const std::string name = "c" + std::to_string(k);
+			ASSERT_EQ(eval(&ctx, (name + " = " + it->str()).c_str()), 0) << expr;
+			replaced += text.substr(last, it->position() - last) + name;
+			last = it->position() + it->length();
+		}
+		replaced += text.substr(last);
+
+		se_number_t folded = { 0 }, plain = { 0 };
+		se_exception_t e1 = { 0 }, e2 = { 0 };
+		const int s1 = run_number(&ctx, expr, &folded, &e1);
+		const int s2 = run_number(&ctx, replaced.c_str(), &plain, &e2);
+
+		ASSERT_EQ(s1, s2) << expr << " vs " << replaced;
+		if (s1 != 0)
+		{
+			EXPECT_EQ(e1.etype, e2.etype) << expr;
+			EXPECT_EQ(e1.error, e2.error) << expr;
+			continue;
+		}
+
+		EXPECT_EQ(folded.type, plain.type) << expr;
+		EXPECT_EQ(folded.inf, plain.inf) << expr;
+		EXPECT_EQ(folded.nan, plain.nan) << expr;
+		if (folded.type == EN_FLT)
+		{
+			EXPECT_EQ(folded.f, plain.f) << expr;
+		} else
+		{
+			EXPECT_EQ(folded.i, plain.i) << expr;
+		}
+	}
+
+	// 超出int32范围的十进制字面量按浮点数解析，取负后不再溢出
+	se_number_t num = { 0 };
+	se_exception_t e = { 0 };
+	ASSERT_EQ(run_number(&ctx, "-2147483648", &num, &e), 0);
+	EXPECT_EQ(num.type, EN_FLT);
+	EXPECT_EQ(num.f, -2147483648.0);
+
+	se_ctx_destroy(&ctx);
+}
+
+// 以文本描述对象，数组逐元素展开
+static std::string describe(const se_object_t *obj)
+{
+	if (obj == 0L) return "nil";
+
+	while (obj->type == EO_OBJ)
+	{
+		obj = (const se_object_t*)obj->data;
+	}
+
+	if (obj->type == EO_NUM)
+	{
+		const se_number_t *num = (const se_number_t*)obj->data;
+		if (num->nan) return "NaN";
+		if (num->inf) return "Inf";
+		return num->type == EN_FLT ? std::to_string(num->f) : std::to_string(num->i);
+	}
+
+	if (obj->type != EO_ARRAY)
+	{
+		return "type" + std::to_string(obj->type);
+	}
+
+	const se_array_t *array = (const se_array_t*)obj->data;
+	std::string text = "{";
+	for (size_t i = 0; i < array->size; ++i)
+	{
+		text += (i > 0 ? "," : "") + describe(&array->data[i]);
+	}
+	return text + "}";
+}
+
+static se_object_t count_args(se_stack_t *args)
+{	// 返回参数个数
+	static se_number_t argc;
+	argc = parse_int_number((int32_t)args->size, EN_DEC);
+	return wrap2obj(&argc, EO_NUM);
+}
+
+TEST(contextTest, RegisterExecutorMatchesStack)
+{
+	se_context_t stack, reg;
+	ASSERT_EQ(se_ctx_create(&stack), 0);
+	ASSERT_EQ(se_ctx_create(&reg), 0);
+	ASSERT_EQ(se_ctx_set_executor(&reg, SE_EXEC_REGISTER), 0);
+	EXPECT_NE(se_ctx_set_executor(&reg, 7), 0);
+
+	se_function_t fn = { count_args, "n", -1 };
+	ASSERT_EQ(se_ctx_bind(&stack, &fn, EO_FUNC, "n"), 0);
+	ASSERT_EQ(se_ctx_bind(&reg, &fn, EO_FUNC, "n"), 0);
+
+	const char *stmts[] = {
+		"a = 5", "a * 2 + 1", "a += 3", "a <<= 1", "-a", "!a", "~a",
+		"b = {1, 2}, b[0] = 7, b", "b[1]", "(1, 2, 3)", "()", "((1, 2), (3))",
+		"n(1, 2, 3)", "n()", "n((1, 2), 3)", "n(a, b, n(1))", "n(*{1, 2, 3}, 4)",
+		"c = {1, {2, 3}}", "c[1][0] = 9, c", "x = 3, f = 6 * x, g = 5 * f",
+		"{f, g}[1]", "{}", "{1, (2, 3), {}}", "d = e = 4", "d + e", "b[0, 1]",
+		"1 / 0", "7.5 % 2", "q", "q = q", "{1, 2}[5]", "1 = 2", "3(1)",
+		"y = 2 * (3 + 4) * (5 - 1)", "0 && 1 / 0", "a, b, c",
+	};
+
+	for (const char *stmt : stmts)
+	{
+		const int s1 = eval(&stack, stmt);
+		se_exception_t e1 = { 0 };
+		se_catch_any(&e1);
+
+		const int s2 = eval(&reg, stmt);
+		se_exception_t e2 = { 0 };
+		se_catch_any(&e2);
+
+		ASSERT_EQ(s1, s2) << stmt;
+		if (s1 != 0)
+		{
+			EXPECT_EQ(e1.etype, e2.etype) << stmt;
+			EXPECT_EQ(e1.error, e2.error) << stmt;
+			continue;
+		}
+
+		EXPECT_EQ(describe(se_ctx_get_last_ret(&stack)),
+			describe(se_ctx_get_last_ret(&reg))) << stmt;
+	}
+
+	// 程序在首次以寄存器执行时编译寄存器指令，之后重复使用
+	se_program_t prog;
+	ASSERT_EQ(se_ctx_compile(&reg, "a = a + n(a, 1)", &prog), 0);
+	EXPECT_EQ(prog.seus.rvm, (void*)0L);
+	for (int i = 0; i < 3; ++i)
+	{
+		ASSERT_EQ(se_ctx_run(&reg, &prog), 0);
+	}
+	EXPECT_NE(prog.seus.rvm, (void*)0L);
+	ASSERT_EQ(eval(&reg, "a"), 0);
+	EXPECT_EQ(last_number(&reg)->i, 22);
+
+	se_ctx_discard(&reg, &prog);
+	se_ctx_destroy(&reg);
+	se_ctx_destroy(&stack);
+}
+
+TEST(contextTest, SuperinstructionsMatchUnfused)
+{
+	const int modes[] = { SE_FUSE_NONE, SE_FUSE_ALL, SE_FUSE_PROFILE };
+
+	se_context_t ctxs[3];
+	for (int m = 0; m < 3; ++m)
+	{
+		ASSERT_EQ(se_ctx_create(&ctxs[m]), 0);
+		ASSERT_EQ(se_ctx_set_fusion(&ctxs[m], modes[m]), 0);
+
+		se_function_t fn = { count_args, "n", -1 };
+		ASSERT_EQ(se_ctx_bind(&ctxs[m], &fn, EO_FUNC, "n"), 0);
+	}
+	EXPECT_NE(se_ctx_set_fusion(&ctxs[0], 7), 0);
+
+	const char *stmts[] = {
+		"a = 5", "a * 2 + 1", "a += 3", "a <<= 1", "(a)", "(2)", "n(a)", "n(1)", "n(n(a))",
+		"b = {1, 2}, b[1] = 7, b", "b[1]", "b[0] + b[1] * 2", "{b[1]}", "x = 3, y = x * 2 - 1",
+		"x > 1 && y < 10 || 0", "-(x + 1)", "~x & 6", "x == 3.0", "(x) + (y)", "b[a]",
+		"1 / 0", "b[1.5]", "q + 1", "q = q", "1 = 2", "3(1)", "{1, 2}[5]", "b[0] = b[1] + 1",
+	};
+
+	for (const char *stmt : stmts)
+	{
+		int state[3];
+		se_exception_t e[3] = { 0 };
+		for (int m = 0; m < 3; ++m)
+		{
+			state[m] = eval(&ctxs[m], stmt);
+			se_catch_any(&e[m]);
+		}
+
+		for (int m = 1; m < 3; ++m)
+		{
+			ASSERT_EQ(state[0], state[m]) << stmt << " @" << modes[m];
+			if (state[0] != 0)
+			{
+				EXPECT_EQ(e[0].etype, e[m].etype) << stmt;
+				EXPECT_EQ(e[0].error, e[m].error) << stmt;
+				continue;
+			}
+			EXPECT_EQ(describe(se_ctx_get_last_ret(&ctxs[0])),
+				describe(se_ctx_get_last_ret(&ctxs[m]))) << stmt << " @" << modes[m];
+		}
+	}
+
+	// 已融合的程序在统计结束（融合集改变）与切换执行器后仍得到相同的结果
+	for (int m = 0; m < 3; ++m)
+	{
+		se_program_t prog;
+		ASSERT_EQ(eval(&ctxs[m], "k = 0"), 0);
+		ASSERT_EQ(se_ctx_compile(&ctxs[m], "k = k + n(k, 2) - (1) * 2 + b[0] % 3", &prog), 0);
+		for (int i = 1; i <= 3000; ++i)
+		{
+			if (i == 2000)
+			{
+				ASSERT_EQ(se_ctx_set_executor(&ctxs[m], SE_EXEC_REGISTER), 0);
+			}
+			ASSERT_EQ(se_ctx_run(&ctxs[m], &prog), 0) << i << " @" << modes[m];
+			EXPECT_EQ(last_number(&ctxs[m])->i, i * 2) << i << " @" << modes[m];
+		}
+		se_ctx_discard(&ctxs[m], &prog);
+		se_ctx_destroy(&ctxs[m]);
+	}
+}
+
+TEST(contextTest, LongCommaLists)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	se_function_t fn = { count_args, "n", -1 };
+	ASSERT_EQ(se_ctx_bind(&ctx, &fn, EO_FUNC, "n"), 0);
+
+	// 逗号接受的值原地保留在帧中，函数参数与数组元素取帧中连续的值
+	std::string list;
+	for (int i = 0; i < 5000; ++i)
+	{
+		list += (i > 0 ? "," : "") + std::to_string(i % 7);
+	}
+
+	ASSERT_EQ(eval(&ctx, ("n(" + list + ")").c_str()), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 5000);
+
+	ASSERT_EQ(eval(&ctx, ("v = {" + list + "}").c_str()), 0);
+	ASSERT_EQ(eval(&ctx, "v[0] + v[4998] * 10 + v[4999] * 100"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 0 + 0 * 10 + 1 * 100);
+
+	ASSERT_EQ(eval(&ctx, ("(" + list + ")").c_str()), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 4999 % 7);
+
+	// 解构的元素插入已接受的值之后，正在计算的值保持在其后
+	struct { const char *stmt; const char *expect; } cases[] = {
+		{ "a = {1, 2, 3}", "{1,2,3}" },
+		{ "{0, *a, 4}", "{1,2,0,3,4}" },
+		{ "{1 + *{2, 3}, 9}", "{2,4,9}" },
+		{ "{(1, 2), (3, *a), *{*a, 7}}", "{2,1,2,3,3,7}" },
+		{ "n(*a, 1, (2, 3))", "5" },
+		{ "{n() + 1, a[0, 2]}", "{1,3}" },
+		{ "{x = (y = 3, y * 2), (x, y)}", "{6,3}" },
+	};
+	for (const auto &c : cases)
+	{
+		ASSERT_EQ(eval(&ctx, c.stmt), 0) << c.stmt;
+		EXPECT_EQ(describe(se_ctx_get_last_ret(&ctx)), c.expect) << c.stmt;
+	}
+
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, NativeTierMatchesStack)
+{
+	se_context_t stack, jit;
+	ASSERT_EQ(se_ctx_create(&stack), 0);
+	ASSERT_EQ(se_ctx_create(&jit), 0);
+	ASSERT_EQ(se_ctx_set_executor(&jit, SE_EXEC_JIT), 0);
+
+	const char *init = "i = 7; j = -3; h = 0xff; f = 2.5; g = -0.75; z = 0; w = 0.0;"
+		" m = -2147483647 - 1; big = 2147483647";
+	ASSERT_EQ(eval(&stack, init), 0);
+	ASSERT_EQ(eval(&jit, init), 0);
+
+	// 反复执行使语句编译为本机代码，其中包含需要退回解释执行的运算
+	const char *exprs[] = {
+		"i + j * 2", "i / j", "i % j", "j / i", "f * g - i", "i / f", "-f", "-i", "+h",
+		"!z", "!w", "!f", "~h", "h & 0x0f", "h ^ i | 1", "i << 3", "h >> 2", "j >> 1",
+		"i > j", "f >= i", "g < z", "i <= 7", "f == 2.5", "i != i", "f && z", "w || j",
+		"big + 1", "m - 1", "big * 2", "-m", "i / z", "i % z",
+		"f / w", "f % 2", "i << 32", "i << j", "~f", "f & 1", "i, f", "i", "(h)",
+		"(i + 1) * (f - 1) / (j - 2) > 0 && !z", "big * big", "1.0e308 * f",
+	};
+
+	for (const char *expr : exprs)
+	{
+		se_program_t p1, p2;
+		ASSERT_EQ(se_ctx_compile(&stack, expr, &p1), 0) << expr;
+		ASSERT_EQ(se_ctx_compile(&jit, expr, &p2), 0) << expr;
+
+		for (int round = 0; round < 100; ++round)
+		{
+			const int s1 = se_ctx_run(&stack, &p1);
+			se_exception_t e1 = { 0 };
+			se_catch_any(&e1);
+
+			const int s2 = se_ctx_run(&jit, &p2);
+			se_exception_t e2 = { 0 };
+			se_catch_any(&e2);
+
+			ASSERT_EQ(s1, s2) << expr;
+			if (s1 != 0)
+			{
+				ASSERT_EQ(e1.etype, e2.etype) << expr;
+				ASSERT_EQ(e1.error, e2.error) << expr;
+				continue;
+			}
+
+			const se_object_t *r1 = se_ctx_get_last_ret(&stack), *r2 = se_ctx_get_last_ret(&jit);
+			ASSERT_EQ(r1->type, r2->type) << expr;
+			const se_number_t *n1 = last_number(&stack), *n2 = last_number(&jit);
+			ASSERT_NE(n1, (const se_number_t*)0L) << expr;
+			ASSERT_NE(n2, (const se_number_t*)0L) << expr;
+			ASSERT_EQ(n1->type, n2->type) << expr;
+			ASSERT_EQ(n1->inf, n2->inf) << expr;
+			ASSERT_EQ(n1->nan, n2->nan) << expr;
+			if (n1->type == EN_FLT)
+			{
+				ASSERT_EQ(memcmp(&n1->f, &n2->f, sizeof(double)), 0) << expr;
+			} else
+			{
+				ASSERT_EQ(n1->i, n2->i) << expr;
+			}
+		}
+
+		se_ctx_discard(&stack, &p1);
+		se_ctx_discard(&jit, &p2);
+	}
+
+	// 符号类型改变后退回解释执行，并按新的类型重新编译
+	se_program_t prog;
+	ASSERT_EQ(se_ctx_compile(&jit, "i * 2 + 1", &prog), 0);
+	for (int round = 0; round < 300; ++round)
+	{
+		const char *rebind = round % 100 == 50 ? "i = 1.5" : round % 100 == 0 ? "i = 7" : 0L;
+		if (rebind != 0L)
+		{
+			ASSERT_EQ(eval(&jit, rebind), 0);
+		}
+		ASSERT_EQ(se_ctx_run(&jit, &prog), 0);
+		const se_number_t *num = last_number(&jit);
+		ASSERT_NE(num, (const se_number_t*)0L);
+		if (round % 100 < 50)
+		{
+			ASSERT_EQ(num->type, EN_DEC) << round;
+			ASSERT_EQ(num->i, 15) << round;
+		} else
+		{
+			ASSERT_EQ(num->type, EN_FLT) << round;
+			ASSERT_EQ(num->f, 4.0) << round;
+		}
+	}
+	ASSERT_EQ(eval(&jit, "i = {1}"), 0);
+	EXPECT_NE(se_ctx_run(&jit, &prog), 0);
+	se_exception_t e = { 0 };
+	se_catch_any(&e);
+
+	se_ctx_discard(&jit, &prog);
+	se_ctx_destroy(&jit);
+	se_ctx_destroy(&stack);
+}
+
+static int g_touched = 0;
+
+static se_object_t touch(se_stack_t *args)
+{	// 记录调用次数并返回
+	static se_number_t count;
+	count = parse_int_number(++g_touched, EN_DEC);
+	return wrap2obj(&count, EO_NUM);
+}
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int g_deny_exec = 0; // 非0时拒绝将内存设为可执行
+
+// 替换libc的mprotect，模拟代码区无法恢复为可执行
+extern "C" int mprotect(void *addr, size_t len, int prot)
+{
+	if (g_deny_exec && (prot & PROT_EXEC))
+	{
+		errno = EACCES;
+		return -1;
+	}
+	return (int)syscall(SYS_mprotect, addr, len, prot);
+}
+
+static void run_times(se_context_t *ctx, se_program_t *prog, int times, int expect)
+{
+	for (int i = 0; i < times; ++i)
+	{
+		ASSERT_EQ(se_ctx_run(ctx, prog), 0);
+		ASSERT_EQ(last_number(ctx)->i, expect);
+	}
+}
+
+TEST(contextTest, NativeInstallFailure)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+	ASSERT_EQ(se_ctx_set_executor(&ctx, SE_EXEC_JIT), 0);
+	ASSERT_EQ(eval(&ctx, "i = 7"), 0);
+
+	se_program_t a, b, c;
+	ASSERT_EQ(se_ctx_compile(&ctx, "i * 3 + 1", &a), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, "i * 5 - 2", &b), 0);
+	ASSERT_EQ(se_ctx_compile(&ctx, "i - 4", &c), 0);
+
+	// 首个语句安装失败：仅含该语句的代码区解除映射，之后的语句仍可编译
+	g_deny_exec = 1;
+	run_times(&ctx, &a, 100, 22);
+	g_deny_exec = 0;
+	run_times(&ctx, &a, 100, 22);
+	run_times(&ctx, &b, 100, 33);
+
+	// 代码区已有语句时安装失败：已编译的语句改为解释执行，不会执行不可执行的代码
+	g_deny_exec = 1;
+	run_times(&ctx, &c, 100, 3);
+	g_deny_exec = 0;
+	run_times(&ctx, &b, 100, 33);
+	run_times(&ctx, &c, 100, 3);
+
+	se_ctx_discard(&ctx, &a);
+	se_ctx_discard(&ctx, &b);
+	se_ctx_discard(&ctx, &c);
+	se_ctx_destroy(&ctx);
+}
+#endif
+
+TEST(contextTest, ShortCircuit)
+{
+	const int executors[] = { SE_EXEC_STACK, SE_EXEC_REGISTER, SE_EXEC_JIT };
+
+	for (int executor : executors)
+	{
+		se_context_t ctx;
+		ASSERT_EQ(se_ctx_create(&ctx), 0);
+		ASSERT_EQ(se_ctx_set_executor(&ctx, executor), 0);
+
+		se_function_t fn = { touch, "t", 0 };
+		ASSERT_EQ(se_ctx_bind(&ctx, &fn, EO_FUNC, "t"), 0);
+		ASSERT_EQ(eval(&ctx, "n = 0; z = 0.0; m = 0; arr = {1, 2}"), 0);
+
+		// 左操作数决定结果时右操作数不执行，结果与完整计算相同
+		struct { const char *stmt; int result; int touched; } cases[] = {
+			{ "n > 0 && t()", 0, 0 },
+			{ "n == 0 || t()", 1, 0 },
+			{ "n == 0 && t()", 1, 1 },
+			{ "n > 0 || t() > 5", 0, 1 },
+			{ "0 && t()", 0, 0 },
+			{ "2.5 || t()", 1, 0 },
+			{ "z && (m = 1, t())", 0, 0 },
+			{ "n && t() || t() && n + 1", 1, 1 },
+			{ "(n || z) && t() + t()", 0, 0 },
+			{ "{n && t(), 1 || t()}[0] + 1", 1, 0 },
+			{ "n > 0 && 1 / n || -1 && 2", 1, 0 },
+			{ "n = 1 && t()", 1, 1 },
+		};
+
+		for (const auto &c : cases)
+		{
+			g_touched = 0;
+			ASSERT_EQ(eval(&ctx, c.stmt), 0) << c.stmt << " @" << executor;
+			const se_number_t *num = last_number(&ctx);
+			ASSERT_NE(num, (const se_number_t*)0L) << c.stmt;
+			EXPECT_EQ(num->i, c.result) << c.stmt << " @" << executor;
+			EXPECT_EQ(g_touched, c.touched) << c.stmt << " @" << executor;
+		}
+		ASSERT_EQ(eval(&ctx, "m"), 0); // 被跳过的赋值未执行
+		EXPECT_EQ(last_number(&ctx)->i, 0);
+
+		se_exception_t e = { 0 };
+
+		// 左操作数不为合法数值时仍由运算符报告异常
+		EXPECT_NE(eval(&ctx, "arr && t()"), 0);
+		se_catch_any(&e);
+		EXPECT_EQ(e.etype, TypeError);
+
+		// 解构数组的元素数在执行期才能确定，右操作数照常计算
+		ASSERT_EQ(eval(&ctx, "n = 0; arr2 = {n && *arr}"), 0);
+		ASSERT_EQ(eval(&ctx, "arr2[0] + arr2[1]"), 0);
+		EXPECT_EQ(last_number(&ctx)->i, 1);
+
+		// 反复执行的程序（SE_EXEC_JIT时编译为本机代码）
+		se_program_t prog;
+		ASSERT_EQ(se_ctx_compile(&ctx, "n != 0 && 100 / n > 10 || n < 0", &prog), 0);
+		for (int i = -20; i <= 20; ++i)
+		{
+			for (int round = 0; round < 5; ++round)
+			{
+				char script[32];
+				snprintf(script, sizeof(script), "n = %d", i);
+				ASSERT_EQ(eval(&ctx, script), 0);
+				ASSERT_EQ(se_ctx_run(&ctx, &prog), 0) << i << " @" << executor;
+				EXPECT_EQ(last_number(&ctx)->i, (i != 0 && 100 / i > 10) || i < 0) << i;
+			}
+		}
+
+		se_ctx_discard(&ctx, &prog);
+		se_ctx_destroy(&ctx);
+	}
+}
+
+TEST(contextTest, TemporaryNumbersEscape)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	ASSERT_EQ(eval(&ctx, "a = 1 + 2; b = { -a, a * 4 }; 100 + 200 * 300"), 0);
+	ASSERT_EQ(eval(&ctx, "a"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 3);
+	ASSERT_EQ(eval(&ctx, "b[0] + b[1]"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 9);
+
+	se_program_t prog;
+	ASSERT_EQ(se_ctx_compile(&ctx, "a * 2", &prog), 0);
+	ASSERT_EQ(eval(&ctx, "7 * 7"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 49);
+	ASSERT_EQ(se_ctx_run(&ctx, &prog), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 6);
+
+	se_ctx_discard(&ctx, &prog);
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, SweepReclaimsTemporaries)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	se_program_t prog;
+	ASSERT_EQ(se_ctx_compile(&ctx, "a = { n, { n * 2, 3.5 } }, n += 1", &prog), 0);
+	ASSERT_EQ(eval(&ctx, "n = 0; keep = { 7, 8 }"), 0);
+
+	// 每轮分配多个id，不回收时将耗尽16位id空间
+	for (int i = 0; i < 50000; ++i)
+	{
+		ASSERT_EQ(se_ctx_run(&ctx, &prog), 0) << "round " << i;
+		ASSERT_EQ(se_ctx_sweep(&ctx), 0);
+	}
+
+	ASSERT_EQ(eval(&ctx, "a[1][0] + keep[1] + n"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 49999 * 2 + 8 + 50000);
+
+	se_ctx_discard(&ctx, &prog);
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, SweepSkipsUnboundSymbols)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	ASSERT_EQ(eval(&ctx, "i = 0; keep = { 1, 2 }; drop = { 3, 4 }; alias = drop"), 0);
+	ASSERT_EQ(se_ctx_unbind(&ctx, "drop"), 0);
+
+	// 解绑定的符号不再作为根，仍被其他符号引用的值保留
+	for (int i = 0; i < 30000; ++i)
+	{
+		ASSERT_EQ(eval(&ctx, "t = { i, i * 2 }, i += 1"), 0) << "round " << i;
+		ASSERT_EQ(se_ctx_sweep(&ctx), 0);
+	}
+
+	ASSERT_EQ(eval(&ctx, "alias[1] + keep[0]"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 5);
+
+	se_number_t w = { 0 };
+	w.i = 6;
+	ASSERT_EQ(se_ctx_bind(&ctx, &w, EO_NUM, "drop"), 0);
+	ASSERT_EQ(se_ctx_sweep(&ctx), 0);
+	ASSERT_EQ(eval(&ctx, "drop + alias[0]"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 9);
+
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, ArenaOverflowPromotesEscapes)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	// 长符号名使首次执行超出语句内存区的初始容量
+	std::string script = "a_rather_long_symbol_name = 1";
+	for (int i = 0; i < 32; ++i)
+	{
+		script += ", a_rather_long_symbol_name = a_rather_long_symbol_name + 1";
+	}
+	ASSERT_EQ(eval(&ctx, "x = 0"), 0);
+	script += ", x = { a_rather_long_symbol_name * 2, x }";
+
+	se_program_t prog;
+	ASSERT_EQ(se_ctx_compile(&ctx, script.c_str(), &prog), 0);
+	for (int i = 0; i < 3; ++i)
+	{
+		ASSERT_EQ(se_ctx_run(&ctx, &prog), 0);
+		ASSERT_EQ(eval(&ctx, "7 * 7 * 7"), 0);
+		EXPECT_EQ(last_number(&ctx)->i, 343);
+	}
+
+	ASSERT_EQ(eval(&ctx, "a_rather_long_symbol_name + x[0] + x[1][0] + x[1][1][0]"), 0);
+	EXPECT_EQ(last_number(&ctx)->i, 33 + 66 * 3);
+
+	se_ctx_discard(&ctx, &prog);
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, ConcurrentContexts)
+{
+	std::vector<int> sums(4, 0), errors(4, 0);
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([t, &sums, &errors]() {
+			se_context_t ctx;
+			se_ctx_create(&ctx);
+
+			se_program_t step, fail;
+			se_ctx_compile(&ctx, "s += k * k, k += 1", &step);
+			se_ctx_compile(&ctx, "k / 0", &fail);
+
+			eval(&ctx, "s = 0; k = 1");
+			for (int i = 0; i < 2000; ++i)
+			{
+				se_ctx_run(&ctx, &step);
+				if (i % 100 == 0)
+				{	// 异常仅对本线程可见
+					se_exception_t e;
+					if (se_ctx_run(&ctx, &fail) != 0
+						&& se_catch_err(&e, RuntimeError, IntDivOrModByZero))
+					{
+						++errors[t];
+					}
+				}
+				if (!se_caught()) break;
+			}
+
+			if (eval(&ctx, "s") == 0) sums[t] = last_number(&ctx)->i;
+
+			se_ctx_discard(&ctx, &step);
+			se_ctx_discard(&ctx, &fail);
+			se_ctx_destroy(&ctx);
+		});
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	for (int t = 0; t < 4; ++t)
+	{	// 1^2 + 2^2 + ... + 2000^2（int32回绕）
+		EXPECT_EQ(sums[t], (int32_t)(uint32_t)(2000ull * 2001 * 4001 / 6));
+		EXPECT_EQ(errors[t], 20);
+	}
+}
+
+TEST(contextTest, BatchMatchesRowByRow)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	const size_t nrows = 1000; // 跨越多个分块
+	std::vector<int32_t> a(nrows), b(nrows);
+	std::vector<double>  c(nrows);
+	for (size_t i = 0; i < nrows; ++i)
+	{
+		a[i] = (int32_t)(i * 7919 % 100000) - 50000;
+		b[i] = (int32_t)(i * 104729 % 90000);
+		c[i] = i * 0.25 - 100;
+	}
+
+	const se_column_t columns[] = {
+		{ "a", EN_DEC, a.data() },
+		{ "b", EN_DEC, b.data() },
+		{ "c", EN_FLT, c.data() },
+	};
+
+	ASSERT_EQ(eval(&ctx, "k = 3"), 0);
+
+	const char *formulas[] = {
+		"a * b",              // 整数溢出标记inf
+		"a + b * k",
+		"2 - a * (b - c)",
+		"a % 7 + (k - b) / 3",
+		"-(a << 2) ^ ~b | (a >= b) + !c",
+		"(k + 1) * 2",        // 纯标量
+		"a % 5 != 0 && b / (a % 5) > 100 || k && c", // 分块内部分行短路
+		"(k > 5 && 1 / 0) + a",
+	};
+
+	for (const char *formula : formulas)
+	{
+		se_program_t prog, row;
+		ASSERT_EQ(se_ctx_compile(&ctx, formula, &prog), 0) << formula;
+
+		std::vector<se_number_t> out(nrows);
+		ASSERT_EQ(se_ctx_batch(&ctx, &prog, columns, 3, nrows, out.data()), 0) << formula;
+
+		ASSERT_EQ(se_ctx_compile(&ctx, formula, &row), 0);
+		for (size_t i = 0; i < nrows; i += 37)
+		{
+			char script[128];
+			snprintf(script, sizeof(script), "a = %d; b = %d; c = %.2f",
+				a[i], b[i], c[i]);
+			ASSERT_EQ(eval(&ctx, script), 0);
+			ASSERT_EQ(se_ctx_run(&ctx, &row), 0) << formula << " @" << i;
+
+			const se_number_t *want = last_number(&ctx);
+			ASSERT_NE(want, nullptr);
+			EXPECT_EQ(out[i].type, want->type) << formula << " @" << i;
+			EXPECT_EQ(out[i].inf,  want->inf)  << formula << " @" << i;
+			if (want->type == EN_FLT)
+			{
+				EXPECT_DOUBLE_EQ(out[i].f, want->f) << formula << " @" << i;
+			} else
+			{
+				EXPECT_EQ(out[i].i, want->i) << formula << " @" << i;
+			}
+		}
+
+		se_ctx_discard(&ctx, &row);
+		se_ctx_discard(&ctx, &prog);
+	}
+
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, BatchErrors)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	int32_t x[] = { 1, 2, 0, 4 };
+	const se_column_t columns[] = { { "x", EN_DEC, x } };
+	se_number_t out[4];
+	se_exception_t e;
+
+	se_program_t prog;
+	ASSERT_EQ(se_ctx_compile(&ctx, "12 / x", &prog), 0);
+	EXPECT_NE(se_ctx_batch(&ctx, &prog, columns, 1, 4, out), 0);
+	EXPECT_EQ(se_catch_err(&e, RuntimeError, IntDivOrModByZero), 1);
+	EXPECT_EQ(se_ctx_batch(&ctx, &prog, columns, 1, 2, out), 0);
+	EXPECT_EQ(out[1].i, 6);
+	se_ctx_discard(&ctx, &prog);
+
+	ASSERT_EQ(se_ctx_compile(&ctx, "y = x + 1", &prog), 0);
+	EXPECT_NE(se_ctx_batch(&ctx, &prog, columns, 1, 4, out), 0);
+	EXPECT_EQ(se_catch_err(&e, RuntimeError, NonBatchableUnit), 1);
+	se_ctx_discard(&ctx, &prog);
+
+	ASSERT_EQ(se_ctx_compile(&ctx, "x + undefined", &prog), 0);
+	EXPECT_NE(se_ctx_batch(&ctx, &prog, columns, 1, 4, out), 0);
+	EXPECT_EQ(se_catch_err(&e, TypeError, MathOperationAmongNonNumbers), 1);
+	se_ctx_discard(&ctx, &prog);
+
+	se_ctx_destroy(&ctx);
+}
+
+struct piece_reader
+{
+	std::string text;
+	size_t pos;
+	size_t piece;
+};
+
+static size_t read_piece(void *data, char *buffer, size_t size)
+{
+	piece_reader *reader = (piece_reader*)data;
+	size_t n = std::min(std::min(size, reader->piece), reader->text.size() - reader->pos);
+	memcpy(buffer, reader->text.data() + reader->pos, n);
+	reader->pos += n;
+	return n;
+}
+
+static int drain(se_context_t *ctx)
+{
+	while (se_ctx_complete(ctx) != 0)
+	{
+		if (se_ctx_forward(ctx) != 0) return 1;
+		se_ctx_parse(ctx);
+		if (se_ctx_execute(ctx) != 0) return 1;
+	}
+	return 0;
+}
+
+TEST(contextTest, StreamingReader)
+{
+	// 语句跨越多次读取，且含有超过单次读取长度的语句
+	std::string script = "s = 0;";
+	for (int i = 1; i <= 500; ++i)
+	{
+		script += " s += " + std::to_string(i) + ";\n";
+	}
+	script += "t = 0";
+	for (int i = 0; i < 3000; ++i)
+	{
+		script += " + 1";
+	}
+	script += "; s + t";
+
+	for (size_t piece : { (size_t)5, (size_t)64, (size_t)100000 })
+	{
+		se_context_t ctx;
+		ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+		piece_reader reader = { script, 0, piece };
+		ASSERT_EQ(se_ctx_load_reader(&ctx, read_piece, &reader), 0);
+		ASSERT_EQ(drain(&ctx), 0);
+
+		const se_number_t *num = last_number(&ctx);
+		ASSERT_NE(num, nullptr);
+		EXPECT_EQ(num->i, 500 * 501 / 2 + 3000) << "piece " << piece;
+
+		se_ctx_destroy(&ctx);
+	}
+}
+
+TEST(contextTest, LoadAfterReader)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	// 回调尚未读完时载入的代码在回调的代码之后执行
+	piece_reader reader = { "s = 1; s = s * 10; s = s - 3;", 0, 8 };
+	ASSERT_EQ(se_ctx_load_reader(&ctx, read_piece, &reader), 0);
+	ASSERT_EQ(se_ctx_load(&ctx, "s = s + 5;"), 0);
+	ASSERT_EQ(se_ctx_load(&ctx, "s = s * 2"), 0);
+	ASSERT_EQ(drain(&ctx), 0);
+
+	const se_number_t *num = last_number(&ctx);
+	ASSERT_NE(num, nullptr);
+	EXPECT_EQ(num->i, ((1 * 10 - 3) + 5) * 2);
+
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, LoadLineByLine)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	// 每次载入后执行完毕的代码即被释放，载入不再依赖已有代码的长度
+	ASSERT_EQ(eval(&ctx, "n = 0"), 0);
+	for (int i = 0; i < 20000; ++i)
+	{
+		ASSERT_EQ(se_ctx_load(&ctx, "n += 1"), 0);
+		if (i % 100 == 99)
+		{
+			ASSERT_EQ(drain(&ctx), 0);
+		}
+	}
+
+	ASSERT_EQ(eval(&ctx, "n"), 0);
+	const se_number_t *num = last_number(&ctx);
+	ASSERT_NE(num, nullptr);
+	EXPECT_EQ(num->i, 20000);
+
+	se_ctx_destroy(&ctx);
+}
+
+TEST(contextTest, LoadFile)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	EXPECT_NE(se_ctx_load_file(&ctx, "/nonexistent/script.se"), 0);
+
+	// 文件长度恰为页大小的整数倍时，结尾的'\0'来自附加的匿名页
+	std::string script = "v = 0;";
+	while (script.size() < 4096 - 8)
+	{
+		script += " v += 2;";
+	}
+	script.resize(4096 - 1, ' ');
+	script += "v";
+	ASSERT_EQ(script.size(), 4096u);
+
+	const char *path = "load_file_test.se";
+	FILE *fp = fopen(path, "wb");
+	ASSERT_NE(fp, nullptr);
+	fwrite(script.data(), 1, script.size(), fp);
+	fclose(fp);
+
+	const long expected = 2 * (long)std::count(script.begin(), script.end(), '+');
+
+	ASSERT_EQ(se_ctx_load_file(&ctx, path), 0);
+	ASSERT_EQ(drain(&ctx), 0);
+	const se_number_t *num = last_number(&ctx);
+	ASSERT_NE(num, nullptr);
+	EXPECT_EQ(num->i, expected);
+
+	// 映射在执行完毕前仍有效，环境销毁时解除
+	ASSERT_EQ(se_ctx_load_file(&ctx, path), 0);
+	se_ctx_destroy(&ctx);
+
+	remove(path);
+}
+
+TEST(contextTest, CompileScriptParallel)
+{
+	std::string script = "x = 0; y = 1;";
+	for (int i = 1; i <= 2000; ++i)
+	{
+		script += " x += " + std::to_string(i) + "; y = (y * 3 + x) % 1000003;\n";
+	}
+	script += " ; x + y";
+
+	se_context_t expected;
+	ASSERT_EQ(se_ctx_create(&expected), 0);
+	ASSERT_EQ(eval(&expected, script.c_str()), 0);
+	const se_number_t *want = last_number(&expected);
+	ASSERT_NE(want, nullptr);
+
+	for (int nthreads : { 1, 4, 0 })
+	{
+		se_context_t ctx;
+		ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+		se_script_t compiled;
+		ASSERT_EQ(se_ctx_compile_script(&ctx, script.c_str(), nthreads, &compiled), 0);
+		EXPECT_EQ(compiled.nprogs, 2 + 2 * 2000 + 1);
+
+		for (int i = 0; i < compiled.nprogs; ++i)
+		{
+			ASSERT_EQ(se_ctx_run(&ctx, &compiled.progs[i]), 0);
+		}
+
+		const se_number_t *num = last_number(&ctx);
+		ASSERT_NE(num, nullptr);
+		EXPECT_EQ(num->i, want->i) << "threads " << nthreads;
+
+		se_ctx_discard_script(&ctx, &compiled);
+		se_ctx_destroy(&ctx);
+	}
+
+	se_ctx_destroy(&expected);
+}
+
+TEST(contextTest, CompileScriptReportsFirstError)
+{
+	se_context_t ctx;
+	ASSERT_EQ(se_ctx_create(&ctx), 0);
+
+	std::string script;
+	for (int i = 0; i < 500; ++i)
+	{
+		script += i == 300 ? "(1, 2;" : i == 400 ? "1 +;" : "1 + 1;";
+	}
+
+	se_script_t compiled;
+	se_exception_t e;
+	EXPECT_NE(se_ctx_compile_script(&ctx, script.c_str(), 4, &compiled), 0);
+	EXPECT_EQ(se_catch_err(&e, SyntaxError, NoRightBracket), 1);
+	EXPECT_EQ(compiled.nprogs, 0);
+	EXPECT_EQ(compiled.progs, nullptr);
+
+	se_ctx_destroy(&ctx);
+}
@@ -0,0 +1,89 @@
+#include <se/parser.h>
+#include <se/exception.h>
+#include <gtest/gtest.h>
+
+// 两趟编译的结果，作为单趟编译的参照
+static int compile_twice(token_t *tokens, int ntok, seus_t *seus, se_exception_t *e)
+{
+	int nrp = 0;
+	unit_t *rpn = toks2rpn(tokens, ntok, &nrp);
+	if (se_catch_any(e)) return 1;
+
+	*seus = rpn2seus(rpn, nrp);
+	if (se_catch_any(e))
+	{
+		free_seus(seus);
+		return 1;
+	}
+
+	return 0;
+}
+
+TEST(parserTest, SinglePassMatchesTwoPass)
+{
+	const char *statements[] = {
+		"1 + 2 * 3",
+		"a = b = (c + 1) * -d",
+		"f(1, 2, g(3))[0]",
+		"{1, {2, 3}, ()}[1][0]",
+		"x += y << 2 | ~z && !w",
+		"sum(*{1, 2, 3})",
+		"(1",
+		"1)",
+		"((1, 2)",
+		"{1, 2",
+		"1 +",
+		"(1, 2",
+		"()[0]",
+		"(1,,2)",
+		"a[1](2, 3)",
+		"a[",
+		"(]",
+		"a && b || c && (d || e)",
+		"f(x && *y, z || 1)[0] && g",
+	};
+
+	seus_t reused = { 0 };
+
+	for (const char *statement : statements)
+	{
+		token_t *tokens = 0L;
+		int ntok = 0;
+		str2tokens(statement, &tokens, &ntok);
+		se_exception_t e;
+		se_catch_any(&e);
+		ASSERT_GT(ntok, 0) << statement;
+
+		seus_t expected = { 0 };
+		se_exception_t e1 = { 0 };
+		int state1 = compile_twice(tokens, ntok, &expected, &e1);
+
+		se_exception_t e2 = { 0 };
+		int state2 = toks2seus(tokens, ntok, &reused);
+		se_catch_any(&e2);
+
+		EXPECT_EQ(state1, state2) << statement;
+		EXPECT_EQ(e1.etype, e2.etype) << statement;
+		EXPECT_EQ(e1.error, e2.error) << statement;
+		EXPECT_EQ(e1.extra, e2.extra) << statement;
+
+		if (state1 == 0 && state2 == 0)
+		{
+			EXPECT_EQ(expected.nef, reused.nef) << statement;
+			EXPECT_EQ(expected.nvf, reused.nvf) << statement;
+			EXPECT_EQ(expected.nss, reused.nss) << statement;
+			ASSERT_EQ(expected.nus, reused.nus) << statement;
+			for (int i = 0; i < expected.nus; ++i)
+			{
+				EXPECT_EQ(expected.us[i].type, reused.us[i].type) << statement;
+				EXPECT_EQ(expected.us[i].tok, reused.us[i].tok) << statement;
+				EXPECT_EQ(expected.us[i].idx, reused.us[i].idx) << statement;
+			}
+			free_seus(&expected);
+		}
+
+		se_free(tokens);
+	}
+
+	free_seus(&reused);
+}
@@ -1,5 +1,6 @@
 #include <se/token.h>
 #include <gtest/gtest.h>
+#include <string.h>
 
 TEST(tokenTest, Reset)
 {
@@ -46,6 +47,54 @@ TEST(tokenTest, GetIndent)
 	EXPECT_EQ(token.sub_type, T_IDT_NEWLINE);
 }
 
+TEST(tokenTest, PredictAllCharacters)
+{
+	const char *operators = ",;()[]{}+-%*/&|^~><=!";
+
+	for (int c = 0; c < 256; ++c)
+	{
+		const char s[2] = { (char)c, '\0' };
+
+		int expected = T_INVALID;
+		if (c == '\0') expected = T_NULL;
+		else if (c == '\r' || c == '\n' || c == '\t' || c == ' ') expected = T_INDENT;
+		else if (c >= '0' && c <= '9' || c == '.') expected = T_NUMBER;
+		else if (c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c == '_') expected = T_SYMBOL;
+		else if (strchr(operators, c) != nullptr) expected = T_OPERATOR;
+
+		EXPECT_EQ(predict(s), expected) << "character " << c;
+	}
+}
+
+TEST(tokenTest, GetLongIndent)
+{
+	token_t token;
+	char buffer[128];
+
+	// 覆盖所有对齐位置以及跨越多个16字节分块的空白串
+	for (int offset = 0; offset < 16; ++offset)
+	{
+		for (int len = 1; len < 80; len += 7)
+		{
+			char *s = buffer + offset;
+			memset(s, ' ', len);
+			s[len] = 'x';
+			s[len + 1] = '\0';
+
+			EXPECT_EQ(get_indent(s, &token), (size_t)len);
+			EXPECT_EQ(token.sub_type, T_IDT_BLANK);
+			EXPECT_EQ(token.r, s + len);
+
+			for (int i = 0; i < len; ++i) s[i] = i % 3 ? '\n' : '\r';
+			s[len] = '\0';
+
+			EXPECT_EQ(get_indent(s, &token), (size_t)len);
+			EXPECT_EQ(token.sub_type, T_IDT_NEWLINE);
+			EXPECT_EQ(token.q, s + len - 1);
+		}
+	}
+}
+
 TEST(tokenTest, GetSingleNumber)
 {
 	token_t token;
@@ -90,4 +90,75 @@ TEST(typeTest, ObjectToString)
 
 	se_free(_array_dim1.data);
 	se_free(_array_dim2.data);
-}
\ No newline at end of file
+}
+
+static se_number_t number_of(const char *literal)
+{
+	token_t token;
+	get_number(literal, &token);
+	return parse_number(&token);
+}
+
+TEST(typeTest, ParseIntegerLiterals)
+{
+	EXPECT_EQ(number_of("0").i, 0);
+	EXPECT_EQ(number_of("2147483647").i, 2147483647);
+	EXPECT_EQ(number_of("2147483647").inf, 0);
+
+	// 超出int32范围的十进制整数按浮点数解析
+	EXPECT_EQ(number_of("2147483648").inf, 0);
+	EXPECT_EQ(number_of("2147483648").type, EN_FLT);
+	EXPECT_EQ(number_of("2147483648").f, 2147483648.0);
+	EXPECT_EQ(number_of("99999999999999999999999").type, EN_FLT);
+	EXPECT_EQ(number_of("99999999999999999999999").f, 1e23);
+
+	// 非十进制按32位补码解释
+	EXPECT_EQ(number_of("0xffffffff").i, -1);
+	EXPECT_EQ(number_of("0xffffffff").inf, 0);
+	EXPECT_EQ(number_of("0x100000000").inf, 1);
+	EXPECT_EQ(number_of("0xDeadBeef").i, (int32_t)0xdeadbeef);
+	EXPECT_EQ(number_of("0b101").i, 5);
+	EXPECT_EQ(number_of("0b101").type, EN_BIN);
+	EXPECT_EQ(number_of("0777").i, 0777);
+	EXPECT_EQ(number_of("0777").type, EN_OCT);
+}
+
+TEST(typeTest, ParseFloatLiteralsMatchStrtod)
+{
+	const char *literals[] = {
+		".5", "1.", "0.1", "1.e7", ".5e1", "3.14159", "1e22", "1e23",
+		"9007199254740993.0", "123456789012345678901234567890.0",
+		"1e308", "1e309", "4.9e-324", "2.2250738585072014e-308",
+		"0.000000000000000000000000001", "1.7976931348623157e308",
+		"1e-400", "0.0e10", "12345678901234567e-5", "5e37",
+	};
+
+	for (const char *literal : literals)
+	{
+		se_number_t num = number_of(literal);
+		EXPECT_EQ(num.type, EN_FLT) << literal;
+		EXPECT_EQ(num.f, strtod(literal, nullptr)) << literal;
+	}
+
+	// 随机生成的字面量逐位与strtod一致
+	srand(12345);
+	char literal[64];
+	for (int n = 0; n < 20000; ++n)
+	{
+		int len = 0;
+		int ndigits = 1 + rand() % 18;
+		for (int i = 0; i < ndigits; ++i)
+		{
+			literal[len++] = '0' + (i == 0 ? 1 + rand() % 9 : rand() % 10);
+			if (i == ndigits / 2) literal[len++] = '.';
+		}
+		if (rand() % 2)
+		{
+			len += snprintf(literal + len, sizeof(literal) - len, "e%d", rand() % 80 - 40);
+		}
+		literal[len] = '\0';
+
+		se_number_t num = number_of(literal);
+		ASSERT_EQ(num.f, strtod(literal, nullptr)) << literal;
+	}
+}